@@ -0,0 +1,87 @@
+#include "sv_arena.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+bool LoadArena(const std::string& a_path, Arena& a_arena)
+{
+    a_arena.terrain = Heightfield();
+    a_arena.obstacles.Build({});
+    a_arena.file.Close();
+
+    if (a_path.empty())
+        return true;
+
+    if (!a_arena.file.Open(a_path))
+        return false;
+
+    const std::uint8_t* data = a_arena.file.Data();
+    std::size_t size = a_arena.file.Size();
+
+    MapFileHeader header;
+    if (size < sizeof(header))
+    {
+        std::cerr << "ERROR -> LoadArena : " << a_path << " is too small\n" << std::flush;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MapFileMagic, sizeof(MapFileMagic)) != 0 || header.version < MapFileMinVersion || header.version > MapFileVersion)
+    {
+        std::cerr << "ERROR -> LoadArena : " << a_path << " is not a version " << MapFileMinVersion << " to " << MapFileVersion << " map file\n" << std::flush;
+        return false;
+    }
+
+    if (header.version < 2)
+        header.obstacleCount = 0;
+
+    std::size_t heightsSize = static_cast<std::size_t>(header.width) * header.depth * sizeof(float);
+    std::size_t obstaclesSize = static_cast<std::size_t>(header.obstacleCount) * 6 * sizeof(float);
+    if (size < sizeof(header) + heightsSize + obstaclesSize)
+    {
+        std::cerr << "ERROR -> LoadArena : " << a_path << " is truncated\n" << std::flush;
+        return false;
+    }
+
+    // Le header fait 32 octets et le mapping est aligné sur une page : les floats sont alignés
+    const float* heights = reinterpret_cast<const float*>(data + sizeof(header));
+    if (!a_arena.terrain.Init(heights, header.width, header.depth, header.cellSize, header.originX, header.originZ))
+    {
+        std::cerr << "ERROR -> LoadArena : " << a_path << " has an invalid heightfield ("
+                  << header.width << "x" << header.depth << ", sizes must be multiples of " << TerrainTileSize << ")\n" << std::flush;
+        return false;
+    }
+
+    // Les obstacles sont copiés : le BVH réordonne les boîtes
+    const float* obstacleData = heights + static_cast<std::size_t>(header.width) * header.depth;
+    std::vector<AABB> boxes;
+    boxes.reserve(header.obstacleCount);
+    for (std::uint32_t i = 0; i < header.obstacleCount; ++i)
+    {
+        const float* values = obstacleData + static_cast<std::size_t>(i) * 6;
+        AABB box{ Vector3f(values[0], values[1], values[2]), Vector3f(values[3], values[4], values[5]) };
+        if (box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z)
+        {
+            std::cerr << "ERROR -> LoadArena : " << a_path << " has an invalid obstacle (" << i << ")\n" << std::flush;
+            return false;
+        }
+        boxes.push_back(box);
+    }
+    a_arena.obstacles.Build(std::move(boxes));
+
+    std::cout << "Arena loaded from " << a_path << " (" << header.width << "x" << header.depth
+              << ", " << header.obstacleCount << " obstacles)\n" << std::flush;
+    return true;
+}
+
+bool HasLineOfSight(const Arena& a_arena, const Vector3f& a_from, const Vector3f& a_to)
+{
+    Vector3f delta = a_to - a_from;
+    float distance = delta.magnitude();
+    if (distance <= 0.0f)
+        return true;
+
+    return !a_arena.obstacles.Raycast(a_from, delta / distance, distance);
+}
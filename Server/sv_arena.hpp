@@ -0,0 +1,52 @@
+#ifndef _SV_ARENA_HPP
+#define _SV_ARENA_HPP 1
+
+#include <cstdint>
+#include <string>
+
+#include "sv_bvh.hpp"
+#include "sv_math.hpp"
+#include "sv_mmap.hpp"
+#include "sv_terrain.hpp"
+
+#pragma region MapFile
+
+// Fichier de map binaire (little endian), mappé tel quel en mémoire :
+//   MapFileHeader
+//   width * depth float : hauteurs, par tuiles de TerrainTileSize² (voir Heightfield)
+//   obstacleCount * 6 float : obstacles (min xyz, max xyz), depuis la version 2
+constexpr char MapFileMagic[4] = { 'W', 'E', 'M', 'P' };
+constexpr std::uint32_t MapFileVersion = 2;
+constexpr std::uint32_t MapFileMinVersion = 1; // Version 1 : pas d'obstacles
+
+struct MapFileHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width; // Échantillons en x, multiple de TerrainTileSize
+    std::uint32_t depth; // Échantillons en z, multiple de TerrainTileSize
+    float cellSize;
+    float originX;
+    float originZ;
+    std::uint32_t obstacleCount; // Réservé (0) en version 1
+};
+
+static_assert(sizeof(MapFileHeader) == 32, "MapFileHeader is read directly from the mapped file");
+
+#pragma endregion
+
+// Monde statique partagé par les salles qui jouent sur cette map
+struct Arena
+{
+    MappedFile file;
+    Heightfield terrain;
+    ObstacleBVH obstacles;
+};
+
+// a_path vide -> arène plate
+bool LoadArena(const std::string& a_path, Arena& a_arena);
+
+// Aucun obstacle entre les deux points (le terrain n'est pas testé)
+bool HasLineOfSight(const Arena& a_arena, const Vector3f& a_from, const Vector3f& a_to);
+
+#endif //_SV_ARENA_HPP
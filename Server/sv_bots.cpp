@@ -0,0 +1,330 @@
+#include "sv_bots.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <experimental/random>
+
+namespace
+{
+    // 8 voisines, coûts entiers : 10 en ligne droite, 14 en diagonale
+    constexpr int NeighbourCount = 8;
+    constexpr int NeighbourX[NeighbourCount] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    constexpr int NeighbourZ[NeighbourCount] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    constexpr std::int32_t NeighbourCost[NeighbourCount] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+    constexpr std::uint8_t NoDirection = NeighbourCount;
+
+    constexpr std::int32_t Unreached = std::numeric_limits<std::int32_t>::max();
+
+    // Passage vers la voisine a_neighbour, les diagonales ne coupent pas les coins bloqués
+    bool CanStep(const NavGrid& a_grid, std::uint32_t a_x, std::uint32_t a_z, int a_neighbour, std::uint8_t a_flags, std::uint32_t& a_cell)
+    {
+        std::int64_t x = static_cast<std::int64_t>(a_x) + NeighbourX[a_neighbour];
+        std::int64_t z = static_cast<std::int64_t>(a_z) + NeighbourZ[a_neighbour];
+        if (x < 0 || z < 0 || x >= a_grid.Width() || z >= a_grid.Depth())
+            return false;
+
+        a_cell = static_cast<std::uint32_t>(z) * a_grid.Width() + static_cast<std::uint32_t>(x);
+        if (!a_grid.IsWalkable(a_cell, a_flags))
+            return false;
+
+        if (NeighbourX[a_neighbour] != 0 && NeighbourZ[a_neighbour] != 0)
+        {
+            return a_grid.IsWalkable(a_z * a_grid.Width() + static_cast<std::uint32_t>(x), a_flags)
+                && a_grid.IsWalkable(static_cast<std::uint32_t>(z) * a_grid.Width() + a_x, a_flags);
+        }
+
+        return true;
+    }
+
+    std::uint32_t BotHash(std::uint32_t a_first, std::uint32_t a_second)
+    {
+        std::uint32_t hash = a_first * 0x9E3779B1u ^ a_second;
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13;
+        hash *= 0xC2B2AE35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+    // Direction d'errance stable pendant BotWanderPeriod ticks, sans état par bot
+    Vector2f WanderDirection(idSize_t a_id, std::uint32_t a_tick)
+    {
+        std::uint32_t hash = BotHash(a_id, a_tick / BotWanderPeriod);
+        float angle = static_cast<float>(hash & 0xFFFF) / 65536.0f * 6.28318531f;
+        return Vector2f(std::cos(angle), std::sin(angle));
+    }
+}
+
+#pragma region NavGrid
+
+void NavGrid::Build(const Arena& a_arena, const PhysicsSettings& a_physics)
+{
+    const Heightfield& terrain = a_arena.terrain;
+
+    if (terrain.IsFlat())
+    {
+        m_width = BotGridDefaultSize;
+        m_depth = BotGridDefaultSize;
+        m_cellSize = BotGridDefaultCellSize;
+        m_originX = -0.5f * BotGridDefaultSize * BotGridDefaultCellSize;
+        m_originZ = m_originX;
+    }
+    else
+    {
+        std::uint32_t step = (std::max(terrain.Width(), terrain.Depth()) + BotGridMaxSize - 1) / BotGridMaxSize;
+        m_width = (terrain.Width() - 1) / step + 1;
+        m_depth = (terrain.Depth() - 1) / step + 1;
+        m_cellSize = terrain.CellSize() * static_cast<float>(step);
+        m_originX = terrain.OriginX();
+        m_originZ = terrain.OriginZ();
+    }
+    m_invCellSize = 1.0f / m_cellSize;
+
+    // Volume occupé par un humain debout au centre de la cellule
+    float halfCell = m_cellSize * 0.5f;
+    float humanHeight = 2.0f * (a_physics.humanHalfHeight + a_physics.humanRadius);
+
+    m_flags.assign(CellCount(), 0);
+    for (std::uint32_t cell = 0; cell < CellCount(); ++cell)
+    {
+        Vector3f center = CellCenter(cell);
+        TerrainSample ground = terrain.Sample(center.x, center.z);
+
+        if (ground.normal.y >= a_physics.minGroundNormalY)
+            m_flags[cell] |= NAV_Slope;
+
+        AABB volume{ Vector3f(center.x - halfCell, ground.height, center.z - halfCell),
+                     Vector3f(center.x + halfCell, ground.height + humanHeight, center.z + halfCell) };
+        if (!a_arena.obstacles.Overlaps(volume))
+            m_flags[cell] |= NAV_Obstacle;
+    }
+}
+
+std::uint32_t NavGrid::CellAt(const Vector3f& a_position) const
+{
+    float gx = std::clamp((a_position.x - m_originX) * m_invCellSize + 0.5f, 0.0f, static_cast<float>(m_width - 1));
+    float gz = std::clamp((a_position.z - m_originZ) * m_invCellSize + 0.5f, 0.0f, static_cast<float>(m_depth - 1));
+
+    return static_cast<std::uint32_t>(gz) * m_width + static_cast<std::uint32_t>(gx);
+}
+
+Vector3f NavGrid::CellCenter(std::uint32_t a_cell) const
+{
+    return Vector3f(m_originX + static_cast<float>(a_cell % m_width) * m_cellSize, 0.0f,
+                    m_originZ + static_cast<float>(a_cell / m_width) * m_cellSize);
+}
+
+#pragma endregion
+
+#pragma region FlowField
+
+void FlowField::ComputeTowards(const NavGrid& a_grid, std::span<const std::uint32_t> a_sources, std::uint8_t a_flags)
+{
+    m_cost.assign(a_grid.CellCount(), Unreached);
+    m_heap.clear();
+
+    for (std::uint32_t cell : a_sources)
+    {
+        if (m_cost[cell] == 0)
+            continue;
+
+        m_cost[cell] = 0;
+        m_heap.emplace_back(0, cell);
+    }
+
+    Propagate(a_grid, a_flags);
+    BuildDirections(a_grid, a_flags);
+
+    m_valid = !a_sources.empty();
+}
+
+void FlowField::ComputeAway(const NavGrid& a_grid, std::span<const std::uint32_t> a_threats, std::uint8_t a_flags)
+{
+    m_cost.assign(a_grid.CellCount(), Unreached);
+    m_heap.clear();
+
+    for (std::uint32_t cell : a_threats)
+    {
+        if (m_cost[cell] == 0)
+            continue;
+
+        m_cost[cell] = 0;
+        m_heap.emplace_back(0, cell);
+    }
+
+    Propagate(a_grid, a_flags);
+
+    // Inverser la distance donne un champ qui mène au point le plus éloigné. Le facteur 1.2 puis la repropagation
+    // font préférer une sortie un peu plus proche de la menace à un cul-de-sac
+    m_heap.clear();
+    for (std::uint32_t cell = 0; cell < a_grid.CellCount(); ++cell)
+    {
+        if (m_cost[cell] == Unreached)
+            continue;
+
+        m_cost[cell] = -(m_cost[cell] * 6) / 5;
+        m_heap.emplace_back(m_cost[cell], cell);
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+
+    Propagate(a_grid, a_flags);
+    BuildDirections(a_grid, a_flags);
+
+    m_valid = !a_threats.empty();
+}
+
+void FlowField::Propagate(const NavGrid& a_grid, std::uint8_t a_flags)
+{
+    std::make_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+
+    while (!m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        auto [cost, cell] = m_heap.back();
+        m_heap.pop_back();
+
+        if (cost > m_cost[cell])
+            continue;
+
+        std::uint32_t x = cell % a_grid.Width();
+        std::uint32_t z = cell / a_grid.Width();
+        for (int neighbour = 0; neighbour < NeighbourCount; ++neighbour)
+        {
+            std::uint32_t next;
+            if (!CanStep(a_grid, x, z, neighbour, a_flags, next))
+                continue;
+
+            std::int32_t nextCost = cost + NeighbourCost[neighbour];
+            if (nextCost < m_cost[next])
+            {
+                m_cost[next] = nextCost;
+                m_heap.emplace_back(nextCost, next);
+                std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+            }
+        }
+    }
+}
+
+void FlowField::BuildDirections(const NavGrid& a_grid, std::uint8_t a_flags)
+{
+    m_direction.assign(a_grid.CellCount(), NoDirection);
+
+    for (std::uint32_t cell = 0; cell < a_grid.CellCount(); ++cell)
+    {
+        std::uint32_t x = cell % a_grid.Width();
+        std::uint32_t z = cell / a_grid.Width();
+        std::int32_t best = m_cost[cell];
+
+        for (int neighbour = 0; neighbour < NeighbourCount; ++neighbour)
+        {
+            std::uint32_t next;
+            if (CanStep(a_grid, x, z, neighbour, a_flags, next) && m_cost[next] < best)
+            {
+                best = m_cost[next];
+                m_direction[cell] = static_cast<std::uint8_t>(neighbour);
+            }
+        }
+    }
+}
+
+Vector2f FlowField::GetDirection(std::uint32_t a_cell) const
+{
+    constexpr float diagonal = 0.70710678f;
+    static const Vector2f directions[NeighbourCount] = {
+        Vector2f(1.0f, 0.0f), Vector2f(-1.0f, 0.0f), Vector2f(0.0f, 1.0f), Vector2f(0.0f, -1.0f),
+        Vector2f(diagonal, diagonal), Vector2f(diagonal, -diagonal), Vector2f(-diagonal, diagonal), Vector2f(-diagonal, -diagonal)
+    };
+
+    if (!m_valid || m_direction[a_cell] == NoDirection)
+        return Vector2f::Zero();
+
+    return directions[m_direction[a_cell]];
+}
+
+#pragma endregion
+
+void AddBots(std::vector<PlayerData>& a_players, std::size_t a_count, const NavGrid& a_grid)
+{
+    constexpr std::size_t maxPlayers = static_cast<std::size_t>(std::numeric_limits<idSize_t>::max()) + 1;
+
+    for (std::size_t i = 0; i < a_count; ++i)
+    {
+        if (a_players.size() >= maxPlayers)
+        {
+            std::cerr << "ERROR -> AddBots : room is full, only " << i << " bots added\n" << std::flush;
+            return;
+        }
+
+        PlayerData& bot = a_players.emplace_back(static_cast<idSize_t>(a_players.size()));
+        bot.isBot = true;
+        bot.name.assign("Bot " + std::to_string(i + 1));
+        bot.state = (i % BotWormRatio == 0) ? PLAYER_STATE::worm : PLAYER_STATE::human;
+
+        // Cellule de départ au hasard, praticable pour le rôle si possible
+        std::uint8_t flags = bot.IsWorm() ? NAV_Worm : NAV_Human;
+        std::uint32_t cell = 0;
+        for (int attempt = 0; attempt < 16; ++attempt)
+        {
+            cell = static_cast<std::uint32_t>(std::experimental::randint<std::uint32_t>(0, a_grid.CellCount() - 1));
+            if (a_grid.IsWalkable(cell, flags))
+                break;
+        }
+        bot.position = a_grid.CellCenter(cell);
+    }
+}
+
+void UpdateBots(BotNavigation& a_navigation, PlayerSpan a_players, std::span<const SoundSource> a_sounds, std::uint32_t a_tick, std::uint32_t a_now)
+{
+    if (!a_navigation.initialized)
+        return;
+
+    if (a_now - a_navigation.lastUpdate >= static_cast<std::uint32_t>(BotFieldUpdateDelay))
+    {
+        const NavGrid& grid = a_navigation.grid;
+
+        a_navigation.cells.clear();
+        for (const SoundSource& sound : a_sounds)
+        {
+            if (a_now - sound.time <= static_cast<std::uint32_t>(SoundLifetime))
+                a_navigation.cells.push_back(grid.CellAt(sound.position));
+        }
+        if (a_navigation.cells.empty())
+            a_navigation.wormHunt.Clear();
+        else
+            a_navigation.wormHunt.ComputeTowards(grid, a_navigation.cells, NAV_Worm);
+
+        a_navigation.cells.clear();
+        for (const PlayerData& player : a_players)
+        {
+            if (player.IsWorm() && !player.name.empty())
+                a_navigation.cells.push_back(grid.CellAt(player.position));
+        }
+        if (a_navigation.cells.empty())
+            a_navigation.humanFlee.Clear();
+        else
+            a_navigation.humanFlee.ComputeAway(grid, a_navigation.cells, NAV_Human);
+
+        a_navigation.lastUpdate = a_now;
+    }
+
+    // Par bot : une lecture de cellule, le coût du chemin est partagé dans les champs
+    for (PlayerData& player : a_players)
+    {
+        if (!player.isBot || player.state == PLAYER_STATE::dead)
+            continue;
+
+        const FlowField& field = player.IsWorm() ? a_navigation.wormHunt : a_navigation.humanFlee;
+        Vector2f direction = field.GetDirection(a_navigation.grid.CellAt(player.position));
+        if (direction.x == 0.0f && direction.y == 0.0f)
+            direction = WanderDirection(player.id, a_tick);
+
+        player.inputs.direction = direction;
+        player.inputs.jump = !player.IsWorm() && BotHash(player.id, a_tick) % BotJumpChance == 0;
+        player.inputs.inputIndex = a_tick;
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef _SV_BOTS_HPP
+#define _SV_BOTS_HPP 1
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "sv_arena.hpp"
+#include "sv_config.hpp"
+#include "sv_math.hpp"
+#include "sv_players.hpp"
+
+// Son émis par un humain (saut...), les vers s'en servent pour chasser
+struct SoundSource
+{
+    Vector3f position;
+    std::uint32_t time; // get_server_time()
+};
+
+#pragma region Navigation
+
+enum NAV_FLAG : std::uint8_t
+{
+    NAV_Slope = 1 << 0,    // Pente praticable
+    NAV_Obstacle = 1 << 1, // Aucun obstacle (les vers passent dessous)
+
+    NAV_Human = NAV_Slope | NAV_Obstacle,
+    NAV_Worm = NAV_Slope
+};
+
+// Grille de navigation des bots, calquée sur le terrain de l'arène
+class NavGrid
+{
+public:
+    void Build(const Arena& a_arena, const PhysicsSettings& a_physics);
+
+    std::uint32_t Width() const { return m_width; }
+    std::uint32_t Depth() const { return m_depth; }
+    std::uint32_t CellCount() const { return m_width * m_depth; }
+
+    bool IsWalkable(std::uint32_t a_cell, std::uint8_t a_flags) const { return (m_flags[a_cell] & a_flags) == a_flags; }
+
+    // Hors de la grille on prend la cellule du bord
+    std::uint32_t CellAt(const Vector3f& a_position) const;
+    Vector3f CellCenter(std::uint32_t a_cell) const;
+
+private:
+    std::uint32_t m_width = 0;
+    std::uint32_t m_depth = 0;
+    float m_cellSize = 1.0f;
+    float m_invCellSize = 1.0f;
+    float m_originX = 0.0f;
+    float m_originZ = 0.0f;
+
+    std::vector<std::uint8_t> m_flags;
+};
+
+// Pour chaque cellule, la direction vers la voisine la moins coûteuse. Un seul calcul sert à tous les bots
+class FlowField
+{
+public:
+    // Se rapproche de la source la plus proche
+    void ComputeTowards(const NavGrid& a_grid, std::span<const std::uint32_t> a_sources, std::uint8_t a_flags);
+    // S'éloigne des menaces sans se bloquer dans les coins : la distance est inversée puis repropagée
+    void ComputeAway(const NavGrid& a_grid, std::span<const std::uint32_t> a_threats, std::uint8_t a_flags);
+
+    void Clear() { m_valid = false; }
+    bool IsValid() const { return m_valid; }
+
+    // Zero si la cellule n'a pas de meilleure voisine
+    Vector2f GetDirection(std::uint32_t a_cell) const;
+
+private:
+    void Propagate(const NavGrid& a_grid, std::uint8_t a_flags);
+    void BuildDirections(const NavGrid& a_grid, std::uint8_t a_flags);
+
+    std::vector<std::int32_t> m_cost;
+    std::vector<std::uint8_t> m_direction;
+    std::vector<std::pair<std::int32_t, std::uint32_t>> m_heap; // Gardé entre deux calculs : pas d'allocation
+    bool m_valid = false;
+};
+
+#pragma endregion
+
+// Navigation partagée par les bots d'une salle
+struct BotNavigation
+{
+    NavGrid grid;
+    FlowField wormHunt;  // Vers les sons récents
+    FlowField humanFlee; // Loin des vers
+
+    std::vector<std::uint32_t> cells; // Sources du calcul en cours
+    std::uint32_t lastUpdate = 0;
+    bool initialized = false;
+};
+
+// Ajoute a_count bots à la salle, un sur BotWormRatio est un ver
+void AddBots(std::vector<PlayerData>& a_players, std::size_t a_count, const NavGrid& a_grid);
+
+// Remplit les inputs des bots pour ce tick, les champs sont recalculés au plus toutes les BotFieldUpdateDelay ms
+void UpdateBots(BotNavigation& a_navigation, PlayerSpan a_players, std::span<const SoundSource> a_sounds, std::uint32_t a_tick, std::uint32_t a_now);
+
+#endif //_SV_BOTS_HPP
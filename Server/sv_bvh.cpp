@@ -0,0 +1,269 @@
+#include "sv_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+    float Axis(const Vector3f& a_vector, int a_axis)
+    {
+        return a_axis == 0 ? a_vector.x : (a_axis == 1 ? a_vector.y : a_vector.z);
+    }
+
+    Vector3f Inverse(const Vector3f& a_vector)
+    {
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+
+        return Vector3f(a_vector.x != 0.0f ? 1.0f / a_vector.x : infinity,
+                        a_vector.y != 0.0f ? 1.0f / a_vector.y : infinity,
+                        a_vector.z != 0.0f ? 1.0f / a_vector.z : infinity);
+    }
+
+    // Test des slabs sur [bmin, bmax], t est exprimé en fraction du mouvement (invDirection = 1 / mouvement)
+    bool IntersectSlabs(const Vector3f& a_origin, const Vector3f& a_invDirection, const Vector3f& a_min, const Vector3f& a_max, float a_maxT, float& a_tEnter, int& a_axis)
+    {
+        float tEnter = -std::numeric_limits<float>::infinity();
+        float tExit = std::numeric_limits<float>::infinity();
+        a_axis = 0;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float origin = Axis(a_origin, axis);
+            float min = Axis(a_min, axis);
+            float max = Axis(a_max, axis);
+            float inv = Axis(a_invDirection, axis);
+
+            if (std::isinf(inv))
+            {
+                // Mouvement parallèle au slab : dedans ou jamais
+                if (origin < min || origin > max)
+                    return false;
+                continue;
+            }
+
+            float tNear = (min - origin) * inv;
+            float tFar = (max - origin) * inv;
+            if (tNear > tFar)
+                std::swap(tNear, tFar);
+
+            if (tNear > tEnter)
+            {
+                tEnter = tNear;
+                a_axis = axis;
+            }
+            tExit = std::min(tExit, tFar);
+        }
+
+        a_tEnter = tEnter;
+        return tEnter <= tExit && tExit >= 0.0f && tEnter <= a_maxT;
+    }
+}
+
+void ObstacleBVH::Build(std::vector<AABB> a_boxes)
+{
+    m_nodes.clear();
+    m_boxes = std::move(a_boxes);
+
+    if (m_boxes.empty())
+        return;
+
+    std::vector<Vector3f> centers;
+    centers.reserve(m_boxes.size());
+    for (const AABB& box : m_boxes)
+        centers.push_back((box.min + box.max) * 0.5f);
+
+    // Au plus 2n - 1 noeuds : aucune réallocation pendant la construction
+    m_nodes.reserve(m_boxes.size() * 2);
+    m_nodes.emplace_back();
+    BuildNode(0, 0, static_cast<std::uint32_t>(m_boxes.size()), centers);
+}
+
+void ObstacleBVH::BuildNode(std::uint32_t a_nodeIndex, std::uint32_t a_first, std::uint32_t a_count, std::vector<Vector3f>& a_centers)
+{
+    Vector3f min = m_boxes[a_first].min;
+    Vector3f max = m_boxes[a_first].max;
+    Vector3f centerMin = a_centers[a_first];
+    Vector3f centerMax = a_centers[a_first];
+    for (std::uint32_t i = a_first + 1; i < a_first + a_count; ++i)
+    {
+        min = Vector3f(std::min(min.x, m_boxes[i].min.x), std::min(min.y, m_boxes[i].min.y), std::min(min.z, m_boxes[i].min.z));
+        max = Vector3f(std::max(max.x, m_boxes[i].max.x), std::max(max.y, m_boxes[i].max.y), std::max(max.z, m_boxes[i].max.z));
+        centerMin = Vector3f(std::min(centerMin.x, a_centers[i].x), std::min(centerMin.y, a_centers[i].y), std::min(centerMin.z, a_centers[i].z));
+        centerMax = Vector3f(std::max(centerMax.x, a_centers[i].x), std::max(centerMax.y, a_centers[i].y), std::max(centerMax.z, a_centers[i].z));
+    }
+
+    m_nodes[a_nodeIndex].min = min;
+    m_nodes[a_nodeIndex].max = max;
+
+    if (a_count <= BVHMaxLeafSize)
+    {
+        m_nodes[a_nodeIndex].leftOrFirst = a_first;
+        m_nodes[a_nodeIndex].count = a_count;
+        return;
+    }
+
+    // Coupe à la médiane sur l'axe où les centres sont le plus étalés
+    Vector3f spread = centerMax - centerMin;
+    int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+    std::vector<std::uint32_t> order(a_count);
+    std::iota(order.begin(), order.end(), a_first);
+    std::uint32_t half = a_count / 2;
+    std::nth_element(order.begin(), order.begin() + half, order.end(), [&](std::uint32_t a_left, std::uint32_t a_right)
+    {
+        return Axis(a_centers[a_left], axis) < Axis(a_centers[a_right], axis);
+    });
+
+    std::vector<AABB> boxes(a_count);
+    std::vector<Vector3f> centers(a_count);
+    for (std::uint32_t i = 0; i < a_count; ++i)
+    {
+        boxes[i] = m_boxes[order[i]];
+        centers[i] = a_centers[order[i]];
+    }
+    std::copy(boxes.begin(), boxes.end(), m_boxes.begin() + a_first);
+    std::copy(centers.begin(), centers.end(), a_centers.begin() + a_first);
+
+    // Les deux enfants sont alloués ensemble pour rester contigus
+    std::uint32_t left = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+    m_nodes[a_nodeIndex].leftOrFirst = left;
+    m_nodes[a_nodeIndex].count = 0;
+
+    BuildNode(left, a_first, half, a_centers);
+    BuildNode(left + 1, a_first + half, a_count - half, a_centers);
+}
+
+template<typename Visitor>
+void ObstacleBVH::Traverse(const Vector3f& a_origin, const Vector3f& a_invDirection, const Vector3f& a_extent, float a_maxT, Visitor&& a_visitor) const
+{
+    if (m_nodes.empty())
+        return;
+
+    std::uint32_t stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node = m_nodes[stack[--top]];
+
+        float tEnter;
+        int axis;
+        if (!IntersectSlabs(a_origin, a_invDirection, node.min - a_extent, node.max + a_extent, a_maxT, tEnter, axis))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (std::uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i)
+            {
+                const AABB& box = m_boxes[i];
+                if (!IntersectSlabs(a_origin, a_invDirection, box.min - a_extent, box.max + a_extent, a_maxT, tEnter, axis))
+                    continue;
+
+                // Déjà dedans (tEnter < 0) : on laisse sortir au lieu de bloquer
+                if (tEnter < 0.0f)
+                    continue;
+
+                a_maxT = a_visitor(tEnter, axis);
+            }
+            continue;
+        }
+
+        if (top + 2 > BVHMaxDepth)
+            continue;
+
+        stack[top++] = node.leftOrFirst + 1;
+        stack[top++] = node.leftOrFirst;
+    }
+}
+
+bool ObstacleBVH::Raycast(const Vector3f& a_origin, const Vector3f& a_direction, float a_maxDistance, float* a_hitDistance) const
+{
+    if (a_maxDistance <= 0.0f)
+        return false;
+
+    bool hit = false;
+    float closest = 1.0f;
+
+    Traverse(a_origin, Inverse(a_direction * a_maxDistance), Vector3f::Zero(), 1.0f, [&](float a_t, int)
+    {
+        hit = true;
+        closest = a_t;
+        return a_t;
+    });
+
+    if (hit && a_hitDistance != nullptr)
+        *a_hitDistance = closest * a_maxDistance;
+
+    return hit;
+}
+
+bool ObstacleBVH::SweepCapsule(const Capsule& a_capsule, const Vector3f& a_motion, SweepHit& a_hit) const
+{
+    bool hit = false;
+    Vector3f extent(a_capsule.radius, a_capsule.halfHeight + a_capsule.radius, a_capsule.radius);
+
+    Traverse(a_capsule.center, Inverse(a_motion), extent, 1.0f, [&](float a_t, int a_axis)
+    {
+        // La normale s'oppose au mouvement sur l'axe d'entrée
+        Vector3f normal = Vector3f::Zero();
+        float direction = -Axis(a_motion, a_axis);
+        float sign = direction > 0.0f ? 1.0f : -1.0f;
+        if (a_axis == 0) normal.x = sign;
+        else if (a_axis == 1) normal.y = sign;
+        else normal.z = sign;
+
+        hit = true;
+        a_hit.fraction = a_t;
+        a_hit.normal = normal;
+        return a_t;
+    });
+
+    return hit;
+}
+
+bool ObstacleBVH::Overlaps(const AABB& a_box) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    auto overlaps = [&](const Vector3f& a_min, const Vector3f& a_max)
+    {
+        return a_min.x <= a_box.max.x && a_max.x >= a_box.min.x
+            && a_min.y <= a_box.max.y && a_max.y >= a_box.min.y
+            && a_min.z <= a_box.max.z && a_max.z >= a_box.min.z;
+    };
+
+    std::uint32_t stack[BVHMaxDepth];
+    std::size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node = m_nodes[stack[--top]];
+        if (!overlaps(node.min, node.max))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (std::uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i)
+            {
+                if (overlaps(m_boxes[i].min, m_boxes[i].max))
+                    return true;
+            }
+            continue;
+        }
+
+        if (top + 2 > BVHMaxDepth)
+            continue;
+
+        stack[top++] = node.leftOrFirst + 1;
+        stack[top++] = node.leftOrFirst;
+    }
+
+    return false;
+}
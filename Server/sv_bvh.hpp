@@ -0,0 +1,72 @@
+#ifndef _SV_BVH_HPP
+#define _SV_BVH_HPP 1
+
+#include <cstdint>
+#include <vector>
+
+#include "sv_math.hpp"
+
+// Nombre max de boîtes par feuille
+constexpr std::uint32_t BVHMaxLeafSize = 2;
+// Profondeur max de la pile de parcours (arbre équilibré : 2^32 feuilles)
+constexpr std::size_t BVHMaxDepth = 64;
+
+struct AABB
+{
+    Vector3f min;
+    Vector3f max;
+};
+
+// Noeud de 32 octets, l'arbre est un tableau plat : les deux enfants d'un noeud interne sont contigus
+struct alignas(32) BVHNode
+{
+    Vector3f min;
+    std::uint32_t leftOrFirst; // Interne : index de l'enfant gauche (le droit suit). Feuille : première boîte
+    Vector3f max;
+    std::uint32_t count;       // 0 -> noeud interne
+};
+
+static_assert(sizeof(BVHNode) == 32, "BVHNode must stay 32 bytes");
+
+// Capsule verticale : segment [center - halfHeight, center + halfHeight] sur y, de rayon radius
+struct Capsule
+{
+    Vector3f center;
+    float halfHeight;
+    float radius;
+};
+
+struct SweepHit
+{
+    float fraction; // [0, 1] le long du mouvement
+    Vector3f normal;
+};
+
+// Obstacles statiques d'une map, construits une fois au chargement
+class ObstacleBVH
+{
+public:
+    void Build(std::vector<AABB> a_boxes);
+
+    bool Empty() const { return m_boxes.empty(); }
+    std::size_t NodeCount() const { return m_nodes.size(); }
+
+    // Premier obstacle touché par le rayon avant a_maxDistance (a_direction normalisée)
+    bool Raycast(const Vector3f& a_origin, const Vector3f& a_direction, float a_maxDistance, float* a_hitDistance = nullptr) const;
+
+    // Première collision de la capsule déplacée de a_motion. Les boîtes sont gonflées par la capsule (coins carrés, conservateur)
+    bool SweepCapsule(const Capsule& a_capsule, const Vector3f& a_motion, SweepHit& a_hit) const;
+
+    // Au moins un obstacle chevauche la boîte
+    bool Overlaps(const AABB& a_box) const;
+
+private:
+    void BuildNode(std::uint32_t a_nodeIndex, std::uint32_t a_first, std::uint32_t a_count, std::vector<Vector3f>& a_centers);
+
+    template<typename Visitor> void Traverse(const Vector3f& a_origin, const Vector3f& a_invDirection, const Vector3f& a_extent, float a_maxT, Visitor&& a_visitor) const;
+
+    std::vector<BVHNode> m_nodes;
+    std::vector<AABB> m_boxes;
+};
+
+#endif //_SV_BVH_HPP
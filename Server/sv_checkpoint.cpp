@@ -0,0 +1,119 @@
+#include "sv_checkpoint.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#include "sv_mmap.hpp"
+
+std::string GetShardCheckpointPath(const std::string& a_path, std::size_t a_shard)
+{
+    return a_shard == 0 ? a_path : a_path + "." + std::to_string(a_shard);
+}
+
+bool SaveCheckpoint(const std::string& a_path, const Checkpoint& a_checkpoint, std::span<const PlayerData> a_players)
+{
+    std::string temporaryPath = a_path + ".tmp";
+
+    {
+        MappedFile file;
+        if (!file.Create(temporaryPath, sizeof(CheckpointHeader) + a_players.size() * sizeof(PlayerData)))
+            return false;
+
+        CheckpointHeader header{};
+        std::memcpy(header.magic, CheckpointMagic, sizeof(CheckpointMagic));
+        header.version = CheckpointVersion;
+        header.playerDataSize = sizeof(PlayerData);
+        header.playerCount = static_cast<std::uint32_t>(a_players.size());
+        header.tick = a_checkpoint.tick;
+        header.serverTime = a_checkpoint.serverTime;
+        header.socket = a_checkpoint.socket;
+        header.port = a_checkpoint.port;
+        header.gameState = static_cast<std::uint8_t>(a_checkpoint.state);
+        header.shard = a_checkpoint.shard;
+        header.shardCount = a_checkpoint.shardCount;
+
+        std::uint8_t* data = file.MutableData();
+        std::memcpy(data, &header, sizeof(header));
+        data += sizeof(header);
+
+        for (const PlayerData& player : a_players)
+        {
+            PlayerData record = player;
+            record.peer = nullptr; // N'a pas de sens dans un autre processus
+
+            std::memcpy(data, &record, sizeof(record));
+            data += sizeof(record);
+        }
+
+        if (!file.Flush())
+        {
+            std::cerr << "ERROR -> SaveCheckpoint : Cannot write " << temporaryPath << "\n" << std::flush;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, a_path, error);
+    if (error)
+    {
+        std::cerr << "ERROR -> SaveCheckpoint : Cannot rename " << temporaryPath << " to " << a_path << " (" << error.message() << ")\n" << std::flush;
+        return false;
+    }
+
+    return true;
+}
+
+bool LoadCheckpoint(const std::string& a_path, Checkpoint& a_checkpoint, std::vector<PlayerData>& a_players)
+{
+    MappedFile file;
+    if (!file.Open(a_path))
+        return false;
+
+    const std::uint8_t* data = file.Data();
+    std::size_t size = file.Size();
+
+    CheckpointHeader header;
+    if (size < sizeof(header))
+    {
+        std::cerr << "ERROR -> LoadCheckpoint : " << a_path << " is too small\n" << std::flush;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, CheckpointMagic, sizeof(CheckpointMagic)) != 0 || header.version != CheckpointVersion || header.playerDataSize != sizeof(PlayerData))
+    {
+        std::cerr << "ERROR -> LoadCheckpoint : " << a_path << " is not a version " << CheckpointVersion << " checkpoint for this build\n" << std::flush;
+        return false;
+    }
+
+    if (size < sizeof(header) + static_cast<std::size_t>(header.playerCount) * sizeof(PlayerData))
+    {
+        std::cerr << "ERROR -> LoadCheckpoint : " << a_path << " is truncated\n" << std::flush;
+        return false;
+    }
+
+    a_checkpoint.state = static_cast<GAME_STATE>(header.gameState);
+    a_checkpoint.tick = header.tick;
+    a_checkpoint.serverTime = header.serverTime;
+    a_checkpoint.socket = header.socket;
+    a_checkpoint.port = header.port;
+    a_checkpoint.shard = header.shard;
+    a_checkpoint.shardCount = header.shardCount;
+
+    a_players.clear();
+    a_players.reserve(header.playerCount);
+
+    data += sizeof(header);
+    for (std::uint32_t i = 0; i < header.playerCount; ++i)
+    {
+        PlayerData& player = a_players.emplace_back(static_cast<idSize_t>(i));
+        std::memcpy(&player, data, sizeof(PlayerData));
+        data += sizeof(PlayerData);
+
+        player.peer = nullptr;
+    }
+
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef _SV_CHECKPOINT_HPP
+#define _SV_CHECKPOINT_HPP 1
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "sv_constant.hpp"
+#include "sv_players.hpp"
+
+#pragma region CheckpointFile
+
+// Checkpoint de redémarrage à chaud, relu par le nouveau binaire sur la même machine (endianness native) :
+//   CheckpointHeader
+//   playerCount * PlayerData, copiés tels quels (peer remis à nullptr)
+// La version doit changer avec le layout de PlayerData. playerDataSize rattrape les oublis les plus courants
+constexpr char CheckpointMagic[4] = { 'W', 'E', 'C', 'P' };
+constexpr std::uint32_t CheckpointVersion = 5; // 2 : shards, 3 : connexion dans PlayerData, 4 : état Q16.16, 5 : RTT et groupe
+
+struct CheckpointHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t playerDataSize;
+    std::uint32_t playerCount;
+    std::uint32_t tick;
+    std::uint32_t serverTime;
+    std::int64_t socket; // Socket UDP transmis au nouveau processus à travers exec, -1 -> aucun
+    std::uint16_t port;
+    std::uint8_t gameState;
+    std::uint8_t shard;
+    std::uint8_t shardCount; // Un checkpoint par shard, voir GetShardCheckpointPath
+    std::uint8_t padding[3];
+};
+
+static_assert(sizeof(CheckpointHeader) == 40, "CheckpointHeader is written directly to the mapped file");
+static_assert(sizeof(CheckpointHeader) % alignof(PlayerData) == 0, "Player records must stay aligned in the mapped file");
+
+#pragma endregion
+
+// État d'une salle en dehors des joueurs
+struct Checkpoint
+{
+    GAME_STATE state = GAME_STATE::waiting;
+    std::uint32_t tick = 0;
+    std::uint32_t serverTime = 0;
+    std::int64_t socket = -1;
+    std::uint16_t port = 0;
+    std::uint8_t shard = 0;
+    std::uint8_t shardCount = 1;
+};
+
+// Shard 0 -> a_path, les suivants -> a_path.<shard>
+std::string GetShardCheckpointPath(const std::string& a_path, std::size_t a_shard);
+
+// Écrit dans un fichier temporaire puis le renomme : un checkpoint lu est toujours complet
+bool SaveCheckpoint(const std::string& a_path, const Checkpoint& a_checkpoint, std::span<const PlayerData> a_players);
+
+bool LoadCheckpoint(const std::string& a_path, Checkpoint& a_checkpoint, std::vector<PlayerData>& a_players);
+
+#endif //_SV_CHECKPOINT_HPP
@@ -0,0 +1,237 @@
+#include "sv_compress.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "sv_protocol.hpp"
+
+namespace
+{
+    // Motifs fréquents de nos messages (entiers et floats big endian, longueurs de chaîne, noms par défaut)
+    constexpr std::uint8_t Dictionary[] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x06, 'P', 'l', 'a', 'y', 'e', 'r',
+        0x00, 0x00, 0x00, 0x05, 'B', 'o', 't', ' ', '1',
+        0x00, 0x00, 0x00, 0x05, 'B', 'o', 't', ' ', '2',
+        0x3F, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xBF, 0x80, 0x00, 0x00, // 1.0f, 0.0f, -1.0f
+        0x3F, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0xC1, 0x1C, 0xF5, 0xC3, // 0.5f, 2.0f, -9.81f
+        0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x05, 0x00, 0x06, 0x00, 0x07, 0x00, 0x08
+    };
+    constexpr std::size_t DictionarySize = sizeof(Dictionary);
+
+    constexpr std::size_t HashBits = 12;
+
+    std::size_t Hash(const std::uint8_t* a_data)
+    {
+        std::uint32_t value;
+        std::memcpy(&value, a_data, sizeof(value));
+        return (value * 2654435761u) >> (32 - HashBits);
+    }
+
+    void WriteLength(byteArray_t& a_output, std::size_t a_length)
+    {
+        while (a_length >= 255)
+        {
+            a_output.push_back(255);
+            a_length -= 255;
+        }
+        a_output.push_back(static_cast<std::uint8_t>(a_length));
+    }
+
+    bool ReadLength(std::span<const std::uint8_t> a_input, std::size_t& a_offset, std::size_t& a_length)
+    {
+        if (a_length != 15)
+            return true;
+
+        std::uint8_t value;
+        do
+        {
+            if (a_offset >= a_input.size())
+                return false;
+
+            value = a_input[a_offset++];
+            a_length += value;
+        } while (value == 255);
+
+        return true;
+    }
+
+    // a_matchLength == 0 : dernière séquence, littéraux seuls
+    void WriteSequence(byteArray_t& a_output, const std::uint8_t* a_literals, std::size_t a_literalCount, std::size_t a_distance, std::size_t a_matchLength)
+    {
+        std::size_t matchCode = a_matchLength > 0 ? a_matchLength - CompressionMinMatch : 0;
+
+        std::uint8_t token = static_cast<std::uint8_t>((std::min<std::size_t>(a_literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15));
+        a_output.push_back(token);
+        if (a_literalCount >= 15)
+            WriteLength(a_output, a_literalCount - 15);
+
+        a_output.insert(a_output.end(), a_literals, a_literals + a_literalCount);
+
+        if (a_matchLength == 0)
+            return;
+
+        a_output.push_back(static_cast<std::uint8_t>(a_distance >> 8));
+        a_output.push_back(static_cast<std::uint8_t>(a_distance & 0xFF));
+        if (matchCode >= 15)
+            WriteLength(a_output, matchCode - 15);
+    }
+
+    struct OpcodeStats
+    {
+        std::atomic<std::uint64_t> messages{ 0 };
+        std::atomic<std::uint64_t> compressed{ 0 }; // Messages effectivement envoyés compressés
+        std::atomic<std::uint64_t> rawBytes{ 0 };
+        std::atomic<std::uint64_t> sentBytes{ 0 };
+        std::atomic<std::uint64_t> nanoseconds{ 0 };
+    };
+
+    std::array<OpcodeStats, 256> s_stats;
+}
+
+bool CompressMessage(byteArray_t& a_message)
+{
+    if (a_message.size() <= 1 + CompressionMinMatch || a_message.size() > CompressionMaxSize)
+        return false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Fenêtre = dictionnaire puis message : les copies peuvent remonter dans le dictionnaire
+    thread_local byteArray_t window;
+    window.assign(Dictionary, Dictionary + DictionarySize);
+    window.insert(window.end(), a_message.begin(), a_message.end());
+
+    thread_local std::array<std::int32_t, 1 << HashBits> table;
+    table.fill(-1);
+    for (std::size_t i = 0; i + CompressionMinMatch <= DictionarySize; ++i)
+        table[Hash(&window[i])] = static_cast<std::int32_t>(i);
+
+    thread_local byteArray_t output;
+    output.clear();
+    Serialize_u8(output, static_cast<std::uint8_t>(OP_CODE::Compressed));
+    Serialize_u16(output, static_cast<std::uint16_t>(a_message.size()));
+
+    std::size_t end = window.size();
+    std::size_t anchor = DictionarySize;
+    std::size_t i = DictionarySize;
+    while (i + CompressionMinMatch <= end && output.size() < a_message.size())
+    {
+        std::size_t hash = Hash(&window[i]);
+        std::int32_t candidate = table[hash];
+        table[hash] = static_cast<std::int32_t>(i);
+
+        if (candidate < 0 || i - static_cast<std::size_t>(candidate) > 0xFFFF || std::memcmp(&window[candidate], &window[i], CompressionMinMatch) != 0)
+        {
+            ++i;
+            continue;
+        }
+
+        std::size_t length = CompressionMinMatch;
+        while (i + length < end && window[candidate + length] == window[i + length])
+            ++length;
+
+        WriteSequence(output, &window[anchor], i - anchor, i - candidate, length);
+
+        for (std::size_t j = i + 1; j < i + length && j + CompressionMinMatch <= end; ++j)
+            table[Hash(&window[j])] = static_cast<std::int32_t>(j);
+
+        i += length;
+        anchor = i;
+    }
+
+    if (anchor < end)
+        WriteSequence(output, &window[anchor], end - anchor, 0, 0);
+
+    bool smaller = output.size() < a_message.size();
+
+    OpcodeStats& stats = s_stats[a_message[0]];
+    stats.messages.fetch_add(1, std::memory_order_relaxed);
+    stats.rawBytes.fetch_add(a_message.size(), std::memory_order_relaxed);
+    stats.sentBytes.fetch_add(smaller ? output.size() : a_message.size(), std::memory_order_relaxed);
+    stats.nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+
+    if (!smaller)
+        return false;
+
+    stats.compressed.fetch_add(1, std::memory_order_relaxed);
+    a_message.assign(output.begin(), output.end());
+    return true;
+}
+
+bool DecompressMessage(std::span<const std::uint8_t> a_input, byteArray_t& a_output)
+{
+    if (a_input.size() < sizeof(std::uint16_t))
+        return false;
+
+    std::size_t rawSize = (static_cast<std::size_t>(a_input[0]) << 8) | a_input[1];
+    std::size_t end = DictionarySize + rawSize;
+    std::size_t offset = sizeof(std::uint16_t);
+
+    // Réservé d'avance : les copies lisent la fenêtre pendant qu'elle grandit
+    thread_local byteArray_t window;
+    window.assign(Dictionary, Dictionary + DictionarySize);
+    window.reserve(end);
+
+    while (window.size() < end)
+    {
+        if (offset >= a_input.size())
+            return false;
+
+        std::uint8_t token = a_input[offset++];
+
+        std::size_t literalCount = token >> 4;
+        if (!ReadLength(a_input, offset, literalCount) || offset + literalCount > a_input.size() || window.size() + literalCount > end)
+            return false;
+
+        window.insert(window.end(), a_input.begin() + offset, a_input.begin() + offset + literalCount);
+        offset += literalCount;
+
+        if (window.size() == end)
+            break;
+
+        if (offset + 2 > a_input.size())
+            return false;
+
+        std::size_t distance = (static_cast<std::size_t>(a_input[offset]) << 8) | a_input[offset + 1];
+        offset += 2;
+
+        std::size_t length = token & 0x0F;
+        if (!ReadLength(a_input, offset, length))
+            return false;
+        length += CompressionMinMatch;
+
+        if (distance == 0 || distance > window.size() || window.size() + length > end)
+            return false;
+
+        // Octet par octet : la copie peut chevaucher ce qu'elle écrit
+        std::size_t from = window.size() - distance;
+        for (std::size_t k = 0; k < length; ++k)
+            window.push_back(window[from + k]);
+    }
+
+    a_output.assign(window.begin() + DictionarySize, window.end());
+    return true;
+}
+
+void PrintCompressionStats(std::ostream& a_stream)
+{
+    for (std::size_t opcode = 0; opcode < s_stats.size(); ++opcode)
+    {
+        const OpcodeStats& stats = s_stats[opcode];
+
+        std::uint64_t messages = stats.messages.load(std::memory_order_relaxed);
+        if (messages == 0)
+            continue;
+
+        std::uint64_t rawBytes = stats.rawBytes.load(std::memory_order_relaxed);
+        std::uint64_t sentBytes = stats.sentBytes.load(std::memory_order_relaxed);
+
+        a_stream << "Compression opcode " << opcode << " : " << stats.compressed.load(std::memory_order_relaxed) << "/" << messages << " compressed, "
+                 << rawBytes << " -> " << sentBytes << " bytes (ratio " << (rawBytes > 0 ? static_cast<double>(sentBytes) / rawBytes : 1.0) << "), "
+                 << stats.nanoseconds.load(std::memory_order_relaxed) / messages << " ns/message\n";
+    }
+    a_stream << std::flush;
+}
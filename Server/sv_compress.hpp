@@ -0,0 +1,26 @@
+#ifndef _SV_COMPRESS_HPP
+#define _SV_COMPRESS_HPP 1
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+
+#include "sv_constant.hpp"
+
+// Codec LZ de type LZ4, amorcé par un dictionnaire commun au client et au serveur (formes de nos packets).
+// Flux : suite de séquences [token][littéraux][u16 distance][extension de longueur]
+//   token : 4 bits de poids fort = nombre de littéraux, 4 bits de poids faible = longueur de copie - 4 (15 -> octets d'extension)
+//   la distance remonte dans dictionnaire + sortie, le flux s'arrête quand la taille décompressée est atteinte
+// Le dictionnaire est dupliqué dans le client (classe Compression, Serialization/ByteBuffer.cs) : les deux doivent rester identiques
+constexpr std::size_t CompressionMinMatch = 4;
+constexpr std::size_t CompressionMaxSize = 0xFFFF; // Taille décompressée stockée sur un u16
+
+// Remplace a_message (opcode + contenu) par sa version OP_CODE::Compressed si elle est plus petite
+bool CompressMessage(byteArray_t& a_message);
+
+// a_input : le flux après l'opcode Compressed. a_output reçoit le message d'origine
+bool DecompressMessage(std::span<const std::uint8_t> a_input, byteArray_t& a_output);
+
+void PrintCompressionStats(std::ostream& a_stream);
+
+#endif //_SV_COMPRESS_HPP
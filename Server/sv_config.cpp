@@ -0,0 +1,379 @@
+#include "sv_config.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+    struct ConfigKey
+    {
+        const char* name;
+        bool structural;
+        std::function<bool(ServerConfig&, std::string_view)> apply;
+    };
+
+    std::string_view Trim(std::string_view str)
+    {
+        const char* whitespaces = " \t\r\n";
+
+        std::size_t begin = str.find_first_not_of(whitespaces);
+        if (begin == std::string_view::npos)
+            return {};
+
+        std::size_t end = str.find_last_not_of(whitespaces);
+        return str.substr(begin, end - begin + 1);
+    }
+
+    template<typename T> bool ParseValue(std::string_view str, T& value)
+    {
+        T parsed{};
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), parsed);
+        if (ec != std::errc() || ptr != str.data() + str.size())
+            return false;
+
+        value = parsed;
+        return true;
+    }
+
+    template<typename T> auto Field(T ServerConfig::* member)
+    {
+        return [member](ServerConfig& config, std::string_view str) { return ParseValue(str, config.*member); };
+    }
+
+    auto Physics(float PhysicsSettings::* member)
+    {
+        return [member](ServerConfig& config, std::string_view str) { return ParseValue(str, config.physics.*member); };
+    }
+
+    auto TickRate(int ServerConfig::* member)
+    {
+        return [member](ServerConfig& config, std::string_view str)
+        {
+            int rate;
+            if (!ParseValue(str, rate) || rate <= 0 || rate > 1000)
+                return false;
+
+            config.*member = rate;
+            return true;
+        };
+    }
+
+    const std::vector<ConfigKey>& GetConfigKeys()
+    {
+        static const std::vector<ConfigKey> keys = {
+            { "port", true, Field(&ServerConfig::port) },
+            { "max_peers", true, Field(&ServerConfig::maxPeers) },
+            { "channel_count", true, [](ServerConfig& config, std::string_view str)
+                {
+                    std::size_t count;
+                    if (!ParseValue(str, count) || count < static_cast<std::size_t>(CHANNEL::Count))
+                        return false;
+
+                    config.channelCount = count;
+                    return true;
+                }
+            },
+
+            { "map_file", true, [](ServerConfig& config, std::string_view str)
+                {
+                    config.mapFile = str;
+                    return true;
+                }
+            },
+
+            { "bot_count", true, Field(&ServerConfig::botCount) },
+            { "listener_shards", true, [](ServerConfig& config, std::string_view str)
+                {
+                    std::size_t count;
+                    if (!ParseValue(str, count) || count == 0 || count > MaxListenerShards)
+                        return false;
+
+                    config.listenerShards = count;
+                    return true;
+                }
+            },
+            { "encode_workers", true, [](ServerConfig& config, std::string_view str)
+                {
+                    std::size_t count;
+                    if (!ParseValue(str, count) || count > MaxEncodeWorkers)
+                        return false;
+
+                    config.encodeWorkers = count;
+                    return true;
+                }
+            },
+            { "control_socket", true, [](ServerConfig& config, std::string_view str)
+                {
+                    config.controlSocket = str;
+                    return true;
+                }
+            },
+
+            { "logic_tick_rate", false, TickRate(&ServerConfig::logicTickRate) },
+            { "network_tick_rate", false, TickRate(&ServerConfig::networkTickRate) },
+            { "incoming_bandwidth", false, Field(&ServerConfig::incomingBandwidth) },
+            { "outgoing_bandwidth", false, Field(&ServerConfig::outgoingBandwidth) },
+            { "peer_bandwidth", false, Field(&ServerConfig::peerBandwidth) },
+            { "stats_log_interval", false, Field(&ServerConfig::statsLogInterval) },
+            { "compression_threshold", false, Field(&ServerConfig::compressionThreshold) },
+            { "session_grace_period", false, Field(&ServerConfig::sessionGracePeriod) },
+            { "match_size", false, [](ServerConfig& config, std::string_view str)
+                {
+                    std::size_t size;
+                    if (!ParseValue(str, size) || size == 1 || size > static_cast<std::size_t>(std::numeric_limits<idSize_t>::max()) + 1)
+                        return false;
+
+                    config.matchSize = size;
+                    return true;
+                }
+            },
+            { "match_rtt_bucket", false, [](ServerConfig& config, std::string_view str)
+                {
+                    std::uint32_t width;
+                    if (!ParseValue(str, width) || width == 0)
+                        return false;
+
+                    config.matchRttBucket = width;
+                    return true;
+                }
+            },
+            { "match_max_wait", false, Field(&ServerConfig::matchMaxWait) },
+            { "checkpoint_file", false, [](ServerConfig& config, std::string_view str)
+                {
+                    if (str.empty())
+                        return false;
+
+                    config.checkpointFile = str;
+                    return true;
+                }
+            },
+            { "max_name_length", false, [](ServerConfig& config, std::string_view str)
+                {
+                    std::size_t length;
+                    if (!ParseValue(str, length) || length == 0 || length > MaxPlayerNameLength)
+                        return false;
+
+                    config.playerNameLength = length;
+                    return true;
+                }
+            },
+
+            { "physics.grounding_tolerance", false, Physics(&PhysicsSettings::groundingTolerance) },
+            { "physics.min_ground_normal_y", false, Physics(&PhysicsSettings::minGroundNormalY) },
+            { "physics.worm_vmax", false, Physics(&PhysicsSettings::wormVMax) },
+            { "physics.worm_acceleration", false, Physics(&PhysicsSettings::wormAcceleration) },
+            { "physics.worm_deceleration", false, Physics(&PhysicsSettings::wormDeceleration) },
+            { "physics.worm_ground_level", false, Physics(&PhysicsSettings::wormGroundLevel) },
+            { "physics.human_vmax", false, Physics(&PhysicsSettings::humanVMax) },
+            { "physics.human_acceleration", false, Physics(&PhysicsSettings::humanAcceleration) },
+            { "physics.human_deceleration", false, Physics(&PhysicsSettings::humanDeceleration) },
+            { "physics.human_ground_level", false, Physics(&PhysicsSettings::humanGroundLevel) },
+            { "physics.human_jump_power", false, Physics(&PhysicsSettings::humanJumpPower) },
+            { "physics.human_radius", false, Physics(&PhysicsSettings::humanRadius) },
+            { "physics.human_half_height", false, Physics(&PhysicsSettings::humanHalfHeight) },
+            { "physics.gravity", false, Physics(&PhysicsSettings::gravity) },
+            { "physics.fixed_point", false, [](ServerConfig& config, std::string_view str)
+                {
+                    int enabled;
+                    if (!ParseValue(str, enabled) || (enabled != 0 && enabled != 1))
+                        return false;
+
+                    config.physics.fixedPoint = enabled != 0;
+                    return true;
+                }
+            },
+        };
+
+        return keys;
+    }
+
+    bool ApplyValue(ServerConfig& config, std::string_view key, std::string_view value, bool allowStructural)
+    {
+        for (const ConfigKey& configKey : GetConfigKeys())
+        {
+            if (key != configKey.name)
+                continue;
+
+            if (configKey.structural && !allowStructural)
+                return true; // Ignoré au rechargement
+
+            if (!configKey.apply(config, value))
+            {
+                std::cerr << "ERROR -> Config : Invalid value \"" << value << "\" for key " << key << "\n" << std::flush;
+                return false;
+            }
+            return true;
+        }
+
+        std::cerr << "ERROR -> Config : Unknown key " << key << "\n" << std::flush;
+        return false;
+    }
+
+    bool ParseFile(const std::string& path, ServerConfig& config, bool allowStructural)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::cerr << "ERROR -> Config : Cannot open " << path << "\n" << std::flush;
+            return false;
+        }
+
+        bool success = true;
+        std::string line;
+        for (std::size_t lineIndex = 1; std::getline(file, line); ++lineIndex)
+        {
+            std::string_view content = line;
+            content = Trim(content.substr(0, content.find('#')));
+            if (content.empty())
+                continue;
+
+            std::size_t separator = content.find('=');
+            if (separator == std::string_view::npos)
+            {
+                std::cerr << "ERROR -> Config : " << path << ":" << lineIndex << " expected key = value\n" << std::flush;
+                success = false;
+                continue;
+            }
+
+            if (!ApplyValue(config, Trim(content.substr(0, separator)), Trim(content.substr(separator + 1)), allowStructural))
+                success = false;
+        }
+
+        return success;
+    }
+
+    bool Build(ConfigSource& source, ServerConfig& config, bool allowStructural)
+    {
+        bool success = true;
+
+        std::error_code ec;
+        if (std::filesystem::exists(source.path, ec))
+        {
+            source.lastWrite = std::filesystem::last_write_time(source.path, ec);
+            success = ParseFile(source.path, config, allowStructural);
+        }
+        else if (source.explicitPath)
+        {
+            std::cerr << "ERROR -> Config : " << source.path << " does not exist\n" << std::flush;
+            success = false;
+        }
+
+        // La ligne de commande a toujours le dernier mot
+        for (const auto& [key, value] : source.overrides)
+        {
+            if (!ApplyValue(config, key, value, allowStructural))
+                success = false;
+        }
+
+        return success;
+    }
+}
+
+bool ParseCommandLine(int argc, char** argv, ConfigSource& source)
+{
+    source.path = DefaultConfigFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "-c" || arg == "--config")
+        {
+            if (i + 1 >= argc)
+                return false;
+
+            source.path = argv[++i];
+            source.explicitPath = true;
+        }
+        else if (arg == "--resume")
+        {
+            if (i + 1 >= argc)
+                return false;
+
+            source.resumePath = argv[++i];
+        }
+        else if (arg == "--sockets")
+        {
+            if (i + 1 >= argc)
+                return false;
+
+            std::string_view sockets = argv[++i];
+            std::size_t separator = sockets.find(':');
+            if (separator == std::string_view::npos || !ParseValue(sockets.substr(0, separator), source.inheritedPort))
+                return false;
+
+            source.inheritedSockets.clear();
+            sockets.remove_prefix(separator + 1);
+            while (!sockets.empty())
+            {
+                std::size_t end = std::min(sockets.find(','), sockets.size());
+                std::int64_t socket;
+                if (!ParseValue(sockets.substr(0, end), socket) || socket < 0)
+                    return false;
+
+                source.inheritedSockets.push_back(socket);
+                sockets.remove_prefix(std::min(end + 1, sockets.size()));
+            }
+        }
+        else if (arg.starts_with("--"))
+        {
+            std::size_t separator = arg.find('=');
+            if (separator == std::string_view::npos)
+                return false;
+
+            source.overrides.emplace_back(arg.substr(2, separator - 2), arg.substr(separator + 1));
+        }
+        else if (i == 1)
+        {
+            // Ancienne syntaxe : WormEaterServer <port>
+            source.overrides.emplace_back("port", arg);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LoadConfig(ConfigSource& source, ServerConfig& config)
+{
+    return Build(source, config, true);
+}
+
+bool ReloadConfigIfChanged(ConfigSource& source, ServerConfig& config)
+{
+    std::error_code ec;
+    std::filesystem::file_time_type lastWrite = std::filesystem::last_write_time(source.path, ec);
+    if (ec || lastWrite == source.lastWrite)
+        return false;
+
+    // On repart de la config actuelle pour garder les valeurs structurelles
+    ServerConfig reloaded = config;
+    if (!Build(source, reloaded, false))
+    {
+        std::cerr << "ERROR -> ReloadConfigIfChanged : " << source.path << " has errors, keeping current config\n" << std::flush;
+        return false;
+    }
+
+    config = reloaded;
+    std::cout << "Config reloaded from " << source.path << "\n" << std::flush;
+
+    return true;
+}
+
+void PrintUsage(const char* program)
+{
+    std::cout << "Usage : " << program << " [port] [-c <config file>] [--resume <checkpoint>] [--sockets <port>:<fd>,...] [--<key>=<value> ...]\n";
+    std::cout << "Keys :\n";
+    for (const ConfigKey& configKey : GetConfigKeys())
+        std::cout << "  " << configKey.name << (configKey.structural ? " (startup only)" : "") << "\n";
+    std::cout << std::flush;
+}
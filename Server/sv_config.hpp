@@ -0,0 +1,111 @@
+#ifndef _SV_CONFIG_HPP
+#define _SV_CONFIG_HPP 1
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sv_constant.hpp"
+
+// Réglages qui dépendent du rôle, résolus une fois par partition de joueurs
+struct RolePhysics
+{
+    float vMax;
+    float acceleration;
+    float deceleration;
+    float groundLevel;
+};
+
+struct PhysicsSettings
+{
+    float groundingTolerance = GroundingTolerance;
+    float minGroundNormalY = MinGroundNormalY;
+
+    // Worm
+    float wormVMax = WVMax;
+    float wormAcceleration = WAcceleration;
+    float wormDeceleration = WDeceleration;
+    float wormGroundLevel = WGroundLevel;
+
+    // Human
+    float humanVMax = HVMax;
+    float humanAcceleration = HAcceleration;
+    float humanDeceleration = HDeceleration;
+    float humanGroundLevel = HGroundLevel;
+    float humanJumpPower = HJumpPower;
+    float humanRadius = HRadius;
+    float humanHalfHeight = HHalfHeight;
+
+    float gravity = HGravity;
+
+    bool fixedPoint = false; // Physique Q16.16 à pas fixe et hash d'état dans les snapshots
+
+    template<PLAYER_ROLE Role> RolePhysics For() const
+    {
+        if constexpr (Role == PLAYER_ROLE::worm)
+            return { wormVMax, wormAcceleration, wormDeceleration, wormGroundLevel };
+        else
+            return { humanVMax, humanAcceleration, humanDeceleration, humanGroundLevel };
+    }
+};
+
+struct ServerConfig
+{
+    // Structural : only read at startup, a reload does not change them
+    std::uint16_t port = 0; // 0 -> random port
+    std::size_t maxPeers = DefaultMaxPeers;
+    std::size_t channelCount = DefaultChannelCount; // >= CHANNEL::Count
+    std::string mapFile; // Vide -> arène plate
+    std::size_t botCount = DefaultBotCount; // Joueurs simulés par le serveur, par salle
+    std::size_t listenerShards = DefaultListenerShards; // ENetHost (et threads) sur le port, une salle par shard
+    std::size_t encodeWorkers = DefaultEncodeWorkers; // Threads d'encodage des envois par shard, en plus du thread de simulation
+    std::string controlSocket; // Socket Unix des commandes d'administration, vide -> désactivé
+
+    // Hot-reloadable
+    int logicTickRate = TICK_LOGIC_RATE; // Hz
+    int networkTickRate = TICK_NETWORK_RATE; // Hz
+    std::uint32_t incomingBandwidth = 0; // bytes/s, 0 -> unlimited
+    std::uint32_t outgoingBandwidth = 0; // bytes/s, 0 -> unlimited
+    std::uint32_t peerBandwidth = 0; // bytes/s envoyés à chaque peer, 0 -> unlimited
+    std::size_t playerNameLength = MaxPlayerNameLength;
+    std::size_t compressionThreshold = DefaultCompressionThreshold; // octets, 0 -> désactivé
+    std::uint32_t sessionGracePeriod = DefaultSessionGracePeriod; // ms, 0 -> pas de reprise
+    std::size_t matchSize = DefaultMatchSize; // Joueurs par partie, 0 -> pas de matchmaking
+    std::uint32_t matchRttBucket = DefaultMatchRttBucket; // ms
+    std::uint32_t matchMaxWait = DefaultMatchMaxWait; // ms, 0 -> jamais d'élargissement
+    std::string checkpointFile = DefaultCheckpointFile; // Écrit au redémarrage à chaud (SIGUSR2)
+    int statsLogInterval = 0; // secondes, 0 -> désactivé
+    PhysicsSettings physics;
+
+    int LogicTickDelay() const { return 1000 / logicTickRate; }
+    int NetworkTickDelay() const { return 1000 / networkTickRate; }
+};
+
+// Garde le chemin du fichier et les overrides de la ligne de commande pour pouvoir recharger
+struct ConfigSource
+{
+    std::string path;
+    bool explicitPath = false;
+    std::vector<std::pair<std::string, std::string>> overrides;
+    std::filesystem::file_time_type lastWrite{};
+
+    std::string resumePath; // --resume : checkpoint laissé par le processus précédent
+
+    // --sockets <port>:<fd>,<fd>... : sockets hérités du processus précédent, un par shard, à adopter même sans checkpoint
+    std::vector<std::int64_t> inheritedSockets;
+    std::uint16_t inheritedPort = 0;
+};
+
+bool ParseCommandLine(int argc, char** argv, ConfigSource& source);
+
+// Charge le fichier + overrides dans config (tous les champs)
+bool LoadConfig(ConfigSource& source, ServerConfig& config);
+
+// Recharge si le fichier a changé, n'applique que les valeurs non structurelles. Retourne true si config a changé
+bool ReloadConfigIfChanged(ConfigSource& source, ServerConfig& config);
+
+void PrintUsage(const char* program);
+
+#endif //_SV_CONFIG_HPP
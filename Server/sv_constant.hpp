@@ -1,7 +1,9 @@
 #ifndef _SV_CONSTANT_HPP
 #define _SV_CONSTANT_HPP 1
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 typedef std::vector<std::uint8_t> byteArray_t;
 
@@ -10,11 +12,124 @@ typedef std::uint8_t idSize_t;
 const std::uint16_t minPort = 1023;
 const std::uint16_t maxPort = 65535;
 
-constexpr int TICK_LOGIC_DELAY = 1000 / 30;
-constexpr int TICK_NETWORK_DELAY = 1000 / 10;
+constexpr int TICK_LOGIC_RATE = 30;
+constexpr int TICK_NETWORK_RATE = 10;
 
+constexpr int TICK_LOGIC_DELAY = 1000 / TICK_LOGIC_RATE;
+constexpr int TICK_NETWORK_DELAY = 1000 / TICK_NETWORK_RATE;
+
+enum class CHANNEL : std::uint8_t
+{
+    Control,  // Fiable : infos joueur, état de partie
+    Snapshot, // Non fiable séquencé : positions
+    Input,    // Non séquencé : inputs client
+
+    Count
+};
+
+enum class SEND_PRIORITY : std::uint8_t
+{
+    Critical, // Toujours envoyé, peut mettre le budget en négatif
+    Low       // Abandonné si le budget du peer est épuisé
+};
+
+// Regroupement des messages (OP_CODE::Bundle) : taille d'un datagramme, sous le MTU ENet moins ses en-têtes
+constexpr std::size_t BundleMaxSize = 1200;
+constexpr std::size_t BundleENetOverhead = 48;
+constexpr std::size_t BundleFrameHeaderSize = 2; // u16 taille
+
+// Options de protocole négociées à la connexion (PlayerInfo -> GameData), en masque de bits
+enum CAPABILITY : std::uint8_t
+{
+    CAPABILITY_Compression = 1 << 0
+};
+
+// Taille à partir de laquelle un message fiable est compressé (0 -> jamais)
+constexpr std::size_t DefaultCompressionThreshold = 128;
+
+// Temps pendant lequel la place d'un joueur coupé lui reste réservée (ms)
+constexpr std::uint32_t DefaultSessionGracePeriod = 10000;
+
+// Matchmaking : les joueurs attendent dans la salle jusqu'à ce qu'une partie de match_size joueurs se forme
+constexpr std::size_t DefaultMatchSize = 0;               // 0 -> désactivé, les joueurs sont en jeu dès leur arrivée
+constexpr std::uint32_t DefaultMatchRttBucket = 50;       // ms de RTT par tranche
+constexpr std::uint32_t DefaultMatchMaxWait = 30000;      // ms d'attente avant d'élargir aux tranches voisines, 0 -> jamais
+constexpr std::size_t MatchRttBuckets = 8;                // La dernière reçoit tous les RTT au-delà
+constexpr std::size_t MaxPartySize = 4;                   // Au-delà, les membres suivants forment un autre ticket
+constexpr std::size_t MatchWormRatio = 4;                 // Un joueur sur MatchWormRatio commence en ver
+
+// Donnée jointe à la déconnexion ENet
+enum class DISCONNECT_REASON : std::uint32_t
+{
+    None,
+    Restart, // Redémarrage à chaud : le client se reconnecte avec son token de session
+    Retry,   // Arrivé sur un autre shard que sa salle : le client se reconnecte depuis un nouveau port
+    Kicked,  // Coupé par un administrateur (socket de contrôle), session supprimée
+    Draining // Serveur en cours d'arrêt : plus de nouvelles connexions
+};
+
+// Shards : un ENetHost par thread, tous sur le même port (SO_REUSEPORT), le noyau répartit les clients
+constexpr std::size_t DefaultListenerShards = 1;
+constexpr std::size_t MaxListenerShards = 64;
+constexpr int SessionTokenShardShift = 56; // Octet de poids fort du token de session = shard
+constexpr int ShardSupervisorDelay = 50;   // ms entre deux vérifications du thread principal (config, stats, redémarrage)
+
+// Files entre le thread réseau et le thread de simulation d'un shard (puissances de 2)
+constexpr std::size_t NetCommandQueueSize = 4096;
+constexpr std::size_t NetOutputQueueSize = 8192;
+constexpr int NetQueueFullTimeout = 100;  // ms d'attente sur une file pleine avant d'abandonner l'élément
+constexpr int ShardOutputPollDelay = 1;   // ms, service du thread réseau tant que la simulation n'a pas fini son tick
+
+// Socket de contrôle (Unix) : commandes d'administration lues par son thread, appliquées entre deux ticks
+constexpr std::size_t AdminQueueSize = 64;    // Par shard, puissance de 2
+constexpr int ControlPollDelay = 100;         // ms, le thread de contrôle vérifie l'arrêt à ce rythme
+constexpr int ControlClientTimeout = 60000;   // ms sans commande avant de fermer la connexion d'un client
+constexpr std::size_t MaxControlLineLength = 256;
+
+// Encodage des envois d'un tick réseau (snapshots, événements) réparti sur des workers, par shard. 0 -> sur le thread de simulation
+constexpr std::size_t DefaultEncodeWorkers = 0;
+constexpr std::size_t MaxEncodeWorkers = 32;
+
+// physics.fixed_point : snapshots réduits au hash tant que le monde ne change pas, un complet au moins tous les N ticks réseau
+constexpr std::uint8_t SnapshotKeyframeInterval = 10;
+
+constexpr const char* DefaultCheckpointFile = "server.checkpoint";
+
+constexpr std::size_t DefaultMaxPeers = 16;
+constexpr std::size_t DefaultChannelCount = static_cast<std::size_t>(CHANNEL::Count);
+
+// Budget max accumulé par peer, en nombre de ticks réseau
+constexpr int PeerBudgetBurstTicks = 2;
+
+constexpr const char* DefaultConfigFile = "server.cfg";
+constexpr int ConfigReloadCheckDelay = 1000;
+
+// Ticks physiques dont on garde l'input appliqué (~2s à 30Hz)
+constexpr std::size_t InputAckHistorySize = 64;
+// Nombre de périodes réseau couvertes par les acks d'un snapshot, pour survivre à la perte d'un snapshot
+constexpr std::uint32_t InputAckRedundancy = 2;
+
+// Taille max absolue, la config peut seulement la réduire
 constexpr std::size_t MaxPlayerNameLength = 24;
 
+#pragma region Bots
+
+    constexpr std::size_t DefaultBotCount = 0;
+    constexpr std::size_t BotWormRatio = 4; // Un bot sur BotWormRatio est un ver
+
+    // Grille de navigation : celle du terrain, sous-échantillonnée au-delà de BotGridMaxSize cellules par côté
+    constexpr std::uint32_t BotGridMaxSize = 128;
+    constexpr std::uint32_t BotGridDefaultSize = 64; // Arène plate
+    constexpr float BotGridDefaultCellSize = 2.0f;
+
+    constexpr int BotFieldUpdateDelay = 250; // ms entre deux recalculs des champs de flux
+    constexpr int SoundLifetime = 2000;      // ms pendant lesquels un son attire les vers
+
+    constexpr std::uint32_t BotWanderPeriod = 90; // Ticks avant de changer de direction d'errance
+    constexpr std::uint32_t BotJumpChance = 90;   // Un saut tous les ~BotJumpChance ticks
+
+#pragma endregion
+
 enum class PLAYER_STATE : std::uint8_t
 {
     unexpected,
@@ -26,6 +141,13 @@ enum class PLAYER_STATE : std::uint8_t
     dead
 };
 
+// Rôle physique d'un joueur : worm pour PLAYER_STATE::worm, human pour tous les autres états
+enum class PLAYER_ROLE : std::uint8_t
+{
+    human,
+    worm
+};
+
 enum class GAME_STATE : std::uint8_t
 {
     waiting,
@@ -35,7 +157,11 @@ enum class GAME_STATE : std::uint8_t
 
 #pragma region PlayerPhysics
 
+    // Valeurs par défaut, surchargeables via la config (PhysicsSettings)
     constexpr float GroundingTolerance = 0.2f;
+    constexpr float MinGroundNormalY = 0.7f; // ~45°, au-delà la pente n'est plus praticable
+
+    // Les niveaux de sol sont relatifs à la hauteur du terrain
 
     // Worm
     constexpr float WVMax = 8.0f;
@@ -54,23 +180,13 @@ enum class GAME_STATE : std::uint8_t
     constexpr float HJumpPower = 6.0f;
     constexpr float HGravity = 9.81f;
 
-    inline float GetVMax(bool IsWorm)
-    {
-        return IsWorm ? WVMax : HVMax;
-    }
-    inline float GetAcceleration(bool IsWorm)
-    {
-        return IsWorm ? WAcceleration : HAcceleration;
-    }
-    inline float GetDeceleration(bool IsWorm)
-    {
-        return IsWorm ? WDeceleration : HDeceleration;
-    }
-    inline float GetGroundLevel(bool IsWorm)
-    {
-        return IsWorm ? WGroundLevel : HGroundLevel;
-    }
-    
+    // Capsule de collision de l'humain contre les obstacles (les vers passent dessous)
+    constexpr float HRadius = 0.4f;
+    constexpr float HHalfHeight = 0.5f;
+
+    constexpr int ObstacleSlideIterations = 3;
+    constexpr float ObstacleSkin = 0.01f; // Distance gardée avec l'obstacle après un contact
+
 #pragma endregion
 
 #endif //_SV_CONSTANT_HPP
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "sv_control.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::string_view ControlHelp =
+        "OK commands : status | kick <shard> <player> | reset <shard> | drain\n";
+
+    // Premier mot de a_line, retiré de a_line
+    std::string_view NextWord(std::string_view& a_line)
+    {
+        std::size_t begin = a_line.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos)
+        {
+            a_line = {};
+            return {};
+        }
+
+        std::size_t end = a_line.find_first_of(" \t\r", begin);
+        if (end == std::string_view::npos)
+            end = a_line.size();
+
+        std::string_view word = a_line.substr(begin, end - begin);
+        a_line.remove_prefix(end);
+        return word;
+    }
+
+    template<typename T> bool ParseNumber(std::string_view str, T& value)
+    {
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        return ec == std::errc() && ptr == str.data() + str.size();
+    }
+}
+
+bool ControlServer::Start(const std::string& a_path, std::vector<AdminQueue*> a_shardQueues)
+{
+#ifdef _WIN32
+    std::cerr << "ERROR -> ControlServer::Start : Control socket is not supported on Windows\n" << std::flush;
+    return false;
+#else
+    Stop();
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (a_path.empty() || a_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "ERROR -> ControlServer::Start : Invalid socket path \"" << a_path << "\"\n" << std::flush;
+        return false;
+    }
+    std::memcpy(address.sun_path, a_path.data(), a_path.size());
+
+    // CLOEXEC : le processus qui remplace celui-ci au redémarrage à chaud recrée son propre socket
+    int listenSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenSocket < 0)
+    {
+        std::cerr << "ERROR -> ControlServer::Start : socket failed (" << std::strerror(errno) << ")\n" << std::flush;
+        return false;
+    }
+
+    // Reste d'un processus précédent (redémarrage à chaud, crash). Un chemin mal saisi ne doit pas effacer un autre fichier
+    struct stat existing;
+    if (::lstat(a_path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            std::cerr << "ERROR -> ControlServer::Start : " << a_path << " exists and is not a socket\n" << std::flush;
+            ::close(listenSocket);
+            return false;
+        }
+
+        ::unlink(a_path.c_str());
+    }
+
+    // Commandes d'administration : seul l'utilisateur du serveur peut se connecter. Le masque couvre la création par bind,
+    // fchmod ne s'applique pas au fichier d'un socket Unix
+    mode_t previousMask = ::umask(0077);
+    int bound = ::bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    ::umask(previousMask);
+
+    if (bound < 0 || ::chmod(a_path.c_str(), S_IRUSR | S_IWUSR) < 0 || ::listen(listenSocket, 4) < 0)
+    {
+        std::cerr << "ERROR -> ControlServer::Start : Cannot listen on " << a_path << " (" << std::strerror(errno) << ")\n" << std::flush;
+        ::close(listenSocket);
+        return false;
+    }
+
+    m_path = a_path;
+    m_listenSocket = listenSocket;
+    m_shardQueues = std::move(a_shardQueues);
+
+    m_running.store(true, std::memory_order_relaxed);
+    m_thread = std::thread(&ControlServer::Run, this);
+    return true;
+#endif
+}
+
+void ControlServer::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_running.store(false, std::memory_order_relaxed);
+    m_thread.join();
+
+#ifndef _WIN32
+    ::close(m_listenSocket);
+    ::unlink(m_path.c_str());
+#endif
+    m_listenSocket = -1;
+}
+
+void ControlServer::Run()
+{
+#ifndef _WIN32
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        pollfd listenPoll{ m_listenSocket, POLLIN, 0 };
+        if (::poll(&listenPoll, 1, ControlPollDelay) <= 0)
+            continue;
+
+        // Un client à la fois : les commandes d'administration sont rares
+        int client = ::accept4(m_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+            continue;
+
+        // Le fichier est en 0600, mais son répertoire a pu être créé ailleurs : on vérifie aussi l'appelant
+        ucred credentials{};
+        socklen_t length = sizeof(credentials);
+        if (::getsockopt(client, SOL_SOCKET, SO_PEERCRED, &credentials, &length) < 0 || (credentials.uid != ::geteuid() && credentials.uid != 0))
+        {
+            constexpr std::string_view denied = "ERROR permission denied\n";
+            ::send(client, denied.data(), denied.size(), MSG_NOSIGNAL);
+            ::close(client);
+            continue;
+        }
+
+        ServeClient(client);
+        ::close(client);
+    }
+#endif
+}
+
+void ControlServer::ServeClient(int a_client)
+{
+#ifndef _WIN32
+    std::string pending;
+    int idle = 0;
+
+    while (m_running.load(std::memory_order_relaxed) && idle < ControlClientTimeout)
+    {
+        pollfd clientPoll{ a_client, POLLIN, 0 };
+        int ready = ::poll(&clientPoll, 1, ControlPollDelay);
+        if (ready < 0)
+            return;
+        if (ready == 0)
+        {
+            idle += ControlPollDelay;
+            continue;
+        }
+
+        char buffer[MaxControlLineLength];
+        ssize_t received = ::recv(a_client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            return;
+
+        idle = 0;
+        pending.append(buffer, static_cast<std::size_t>(received));
+
+        std::size_t end;
+        while ((end = pending.find('\n')) != std::string::npos)
+        {
+            std::string reply = Execute(std::string_view(pending).substr(0, end));
+            pending.erase(0, end + 1);
+
+            if (!reply.empty() && ::send(a_client, reply.data(), reply.size(), MSG_NOSIGNAL) < 0)
+                return;
+        }
+
+        if (pending.size() > MaxControlLineLength)
+        {
+            constexpr std::string_view tooLong = "ERROR line too long\n";
+            ::send(a_client, tooLong.data(), tooLong.size(), MSG_NOSIGNAL);
+            return;
+        }
+    }
+#endif
+}
+
+std::string ControlServer::Execute(std::string_view a_line)
+{
+    std::string_view command = NextWord(a_line);
+    if (command.empty())
+        return {};
+
+    std::cout << "Control : " << command << a_line << "\n" << std::flush;
+
+    if (command == "help")
+        return std::string(ControlHelp);
+
+    if (command == "status")
+    {
+        if (!m_supervisor.TryPush({ ADMIN_OP::Status }))
+            return "ERROR queue full\n";
+
+        return "OK status written to the server log\n";
+    }
+
+    if (command == "drain")
+    {
+        for (std::size_t i = 0; i < m_shardQueues.size(); ++i)
+        {
+            std::string reply = PushShard(i, { ADMIN_OP::Drain });
+            if (!reply.empty())
+                return reply;
+        }
+
+        if (!m_supervisor.TryPush({ ADMIN_OP::Drain }))
+            return "ERROR queue full\n";
+
+        return "OK draining, the server stops when no player is connected\n";
+    }
+
+    std::size_t shard;
+    if (command == "kick")
+    {
+        idSize_t player;
+        if (!ParseNumber(NextWord(a_line), shard) || !ParseNumber(NextWord(a_line), player))
+            return "ERROR usage : kick <shard> <player>\n";
+
+        std::string reply = PushShard(shard, { ADMIN_OP::Kick, player });
+        return reply.empty() ? "OK\n" : reply;
+    }
+
+    if (command == "reset")
+    {
+        if (!ParseNumber(NextWord(a_line), shard))
+            return "ERROR usage : reset <shard>\n";
+
+        std::string reply = PushShard(shard, { ADMIN_OP::Reset });
+        return reply.empty() ? "OK\n" : reply;
+    }
+
+    return "ERROR unknown command, try help\n";
+}
+
+// Réponse d'erreur, vide si la commande est dans la file
+std::string ControlServer::PushShard(std::size_t a_shard, const AdminCommand& a_command)
+{
+    if (a_shard >= m_shardQueues.size())
+        return "ERROR no shard " + std::to_string(a_shard) + "\n";
+
+    AdminCommand command = a_command;
+    if (!m_shardQueues[a_shard]->TryPush(std::move(command)))
+        return "ERROR shard " + std::to_string(a_shard) + " queue full\n";
+
+    return {};
+}
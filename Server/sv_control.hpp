@@ -0,0 +1,63 @@
+#ifndef _SV_CONTROL_HPP
+#define _SV_CONTROL_HPP 1
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "sv_constant.hpp"
+#include "sv_queue.hpp"
+
+enum class ADMIN_OP : std::uint8_t
+{
+    Status, // Thread principal : état des salles dans le log
+    Kick,   // Shard : coupe un joueur et libère sa place
+    Reset,  // Shard : ferme la salle (joueurs coupés, places libérées) et en ouvre une nouvelle
+    Drain   // Shards : refusent les nouvelles connexions. Thread principal : s'arrête quand plus personne n'est connecté
+};
+
+struct AdminCommand
+{
+    ADMIN_OP op = ADMIN_OP::Status;
+    idSize_t player = 0; // Kick
+};
+
+// Thread de contrôle -> un consommateur (thread de simulation d'un shard ou thread principal)
+using AdminQueue = SpscQueue<AdminCommand, AdminQueueSize>;
+
+// Socket Unix local servi par son propre thread : une commande texte par ligne, réponse "OK" ou "ERROR <raison>".
+// Les commandes ne sont que déposées dans des files sans verrou, la simulation les applique entre deux ticks
+class ControlServer
+{
+public:
+    ControlServer() = default;
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+    ~ControlServer() { Stop(); }
+
+    // a_shardQueues[i] : file lue par le shard i, doit survivre au serveur. Un fichier déjà présent en a_path est remplacé
+    bool Start(const std::string& a_path, std::vector<AdminQueue*> a_shardQueues);
+    void Stop();
+
+    // Thread principal
+    bool PopCommand(AdminCommand& a_command) { return m_supervisor.TryPop(a_command); }
+
+private:
+    void Run();
+    void ServeClient(int a_client);
+    std::string Execute(std::string_view a_line);
+    std::string PushShard(std::size_t a_shard, const AdminCommand& a_command);
+
+    std::string m_path;
+    int m_listenSocket = -1;
+    std::vector<AdminQueue*> m_shardQueues;
+    AdminQueue m_supervisor;
+
+    std::atomic<bool> m_running = false;
+    std::thread m_thread;
+};
+
+#endif //_SV_CONTROL_HPP
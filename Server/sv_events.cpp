@@ -0,0 +1,100 @@
+#include "sv_events.hpp"
+
+#include <algorithm>
+
+#include "sv_network.hpp"
+
+EventBus::EventBus()
+{
+    m_soundSlots.fill(NoSlot);
+    m_attackSlots.fill(NoSlot);
+}
+
+void EventBus::EmitSound(idSize_t a_id, const Vector3f& a_position)
+{
+    ++m_emitted;
+
+    if (m_soundSlots[a_id] != NoSlot)
+    {
+        m_sounds.sounds[m_soundSlots[a_id]].position = a_position;
+        ++m_coalesced;
+        return;
+    }
+
+    m_soundSlots[a_id] = static_cast<std::uint16_t>(m_sounds.sounds.size());
+    m_sounds.sounds.push_back({ a_id, a_position });
+}
+
+void EventBus::EmitWormAttack(idSize_t a_wormId, const Vector3f& a_position, std::span<const idSize_t> a_targets)
+{
+    ++m_emitted;
+
+    WormAttackPacket* attack;
+    if (m_attackSlots[a_wormId] != NoSlot)
+    {
+        attack = &m_attacks[m_attackSlots[a_wormId]];
+        ++m_coalesced;
+    }
+    else
+    {
+        m_attackSlots[a_wormId] = static_cast<std::uint16_t>(m_attacks.size());
+        attack = &m_attacks.emplace_back();
+    }
+
+    attack->attackPosition = a_position;
+    for (idSize_t target : a_targets)
+    {
+        if (std::find(attack->targetId.begin(), attack->targetId.end(), target) == attack->targetId.end())
+            attack->targetId.push_back(target);
+    }
+}
+
+void EventBus::EmitWormNear(idSize_t a_targetId, float a_nearRatio)
+{
+    ++m_emitted;
+
+    if (a_nearRatio <= 0.0f)
+        return;
+
+    if (m_nearRatios[a_targetId] > 0.0f)
+        ++m_coalesced;
+    else
+        ++m_nearCount;
+
+    m_nearRatios[a_targetId] = std::max(m_nearRatios[a_targetId], a_nearRatio);
+}
+
+void EventBus::Flush(const PlayerData& a_recipient, PacketBundler& a_bundler) const
+{
+    // Les attaques sont fiables et passent avant le reste
+    for (const WormAttackPacket& attack : m_attacks)
+    {
+        a_bundler.Add(attack);
+    }
+
+    if (!m_sounds.sounds.empty())
+        a_bundler.Add(m_sounds);
+
+    if (m_nearRatios[a_recipient.id] > 0.0f)
+    {
+        WormNearPacket packet;
+        packet.nearRatio = m_nearRatios[a_recipient.id];
+        a_bundler.Add(packet);
+    }
+}
+
+void EventBus::Clear()
+{
+    for (const auto& sound : m_sounds.sounds)
+        m_soundSlots[sound.id] = NoSlot;
+    m_sounds.sounds.clear();
+
+    m_attackSlots.fill(NoSlot);
+    m_attacks.clear();
+
+    if (m_nearCount > 0)
+    {
+        m_nearRatios.fill(0.0f);
+        m_nearCount = 0;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef _SV_EVENTS_HPP
+#define _SV_EVENTS_HPP 1
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "sv_constant.hpp"
+#include "sv_math.hpp"
+#include "sv_players.hpp"
+#include "sv_protocol.hpp"
+
+class PacketBundler;
+
+// Événements de jeu d'une salle : émis pendant tick_logic, fusionnés, puis envoyés une fois par tick réseau
+class EventBus
+{
+public:
+    EventBus();
+
+    // Un son par joueur et par tick réseau : le dernier remplace les précédents
+    void EmitSound(idSize_t a_id, const Vector3f& a_position);
+    // Une attaque par ver et par tick réseau, les cibles sont fusionnées
+    void EmitWormAttack(idSize_t a_wormId, const Vector3f& a_position, std::span<const idSize_t> a_targets);
+    // Seul le ver le plus proche compte
+    void EmitWormNear(idSize_t a_targetId, float a_nearRatio);
+
+    bool Empty() const { return m_sounds.sounds.empty() && m_attacks.empty() && m_nearCount == 0; }
+
+    // Ajoute au bundle du destinataire ce qui le concerne : au plus un message de sons, une attaque par ver et un WormNear
+    void Flush(const PlayerData& a_recipient, PacketBundler& a_bundler) const;
+    // Appelé après avoir flush tous les destinataires
+    void Clear();
+
+    std::uint64_t EmittedCount() const { return m_emitted; }
+    std::uint64_t CoalescedCount() const { return m_coalesced; }
+
+private:
+    static constexpr std::uint16_t NoSlot = std::numeric_limits<std::uint16_t>::max();
+    static constexpr std::size_t SlotCount = static_cast<std::size_t>(std::numeric_limits<idSize_t>::max()) + 1;
+
+    PlayersMakeSoundPacket m_sounds;
+    std::array<std::uint16_t, SlotCount> m_soundSlots;
+
+    std::vector<WormAttackPacket> m_attacks;
+    std::array<std::uint16_t, SlotCount> m_attackSlots;
+
+    std::array<float, SlotCount> m_nearRatios{}; // 0 -> rien à envoyer
+    std::size_t m_nearCount = 0;
+
+    std::uint64_t m_emitted = 0;
+    std::uint64_t m_coalesced = 0;
+};
+
+#endif //_SV_EVENTS_HPP
@@ -0,0 +1,135 @@
+#ifndef _SV_FIXED_HPP
+#define _SV_FIXED_HPP 1
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "sv_math.hpp"
+
+// Virgule fixe Q16.16 : uniquement des opérations entières, même résultat au bit près quel que soit le compilateur ou la plateforme
+struct Fixed
+{
+    static constexpr int FractionBits = 16;
+    static constexpr std::int32_t One = 1 << FractionBits;
+
+    std::int32_t raw = 0;
+
+    static constexpr Fixed FromRaw(std::int32_t a_raw) { Fixed value; value.raw = a_raw; return value; }
+    static constexpr Fixed FromInt(std::int32_t a_value) { return FromRaw(a_value * One); }
+
+    // Arrondi au plus proche (0.5 loin de zéro), saturé : la multiplication par 2^16 est exacte en float
+    static Fixed FromFloat(float a_value)
+    {
+        float scaled = a_value * static_cast<float>(One);
+        if (!(scaled < static_cast<float>(std::numeric_limits<std::int32_t>::max())))
+            return FromRaw(scaled > 0.0f ? std::numeric_limits<std::int32_t>::max() : 0); // NaN -> 0
+        if (scaled <= static_cast<float>(std::numeric_limits<std::int32_t>::min()))
+            return FromRaw(std::numeric_limits<std::int32_t>::min());
+
+        return FromRaw(static_cast<std::int32_t>(std::lround(scaled)));
+    }
+
+    float ToFloat() const { return static_cast<float>(raw) / static_cast<float>(One); }
+
+    constexpr Fixed operator-() const { return FromRaw(-raw); }
+    constexpr Fixed operator+(Fixed a_other) const { return FromRaw(raw + a_other.raw); }
+    constexpr Fixed operator-(Fixed a_other) const { return FromRaw(raw - a_other.raw); }
+    // Produit sur 64 bits puis décalage arithmétique (arrondi vers -infini)
+    constexpr Fixed operator*(Fixed a_other) const { return FromRaw(static_cast<std::int32_t>((static_cast<std::int64_t>(raw) * a_other.raw) >> FractionBits)); }
+    // Division entière tronquée vers zéro, a_other ne doit pas être nul
+    constexpr Fixed operator/(Fixed a_other) const { return FromRaw(static_cast<std::int32_t>((static_cast<std::int64_t>(raw) * One) / a_other.raw)); }
+
+    constexpr Fixed& operator+=(Fixed a_other) { raw += a_other.raw; return *this; }
+    constexpr Fixed& operator-=(Fixed a_other) { raw -= a_other.raw; return *this; }
+
+    constexpr bool operator==(const Fixed&) const = default;
+    constexpr auto operator<=>(const Fixed&) const = default;
+
+    static constexpr Fixed Zero() { return FromRaw(0); }
+    static constexpr Fixed Min(Fixed a_a, Fixed a_b) { return a_a < a_b ? a_a : a_b; }
+    static constexpr Fixed Max(Fixed a_a, Fixed a_b) { return a_a < a_b ? a_b : a_a; }
+    static constexpr Fixed Clamp(Fixed a_value, Fixed a_min, Fixed a_max) { return Min(Max(a_value, a_min), a_max); }
+
+    // Racine entière de raw * 2^16, par bits décroissants : pas de sqrt flottant
+    static constexpr Fixed Sqrt(Fixed a_value)
+    {
+        if (a_value.raw <= 0)
+            return Zero();
+
+        std::uint64_t remainder = static_cast<std::uint64_t>(a_value.raw) << FractionBits;
+        std::uint64_t root = 0;
+        std::uint64_t bit = std::uint64_t(1) << 62;
+        while (bit > remainder)
+            bit >>= 2;
+
+        while (bit != 0)
+        {
+            if (remainder >= root + bit)
+            {
+                remainder -= root + bit;
+                root = (root >> 1) + bit;
+            }
+            else
+            {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+
+        return FromRaw(static_cast<std::int32_t>(root));
+    }
+};
+
+struct FixedVector3
+{
+    Fixed x;
+    Fixed y;
+    Fixed z;
+
+    static FixedVector3 FromVector(const Vector3f& a_vector) { return { Fixed::FromFloat(a_vector.x), Fixed::FromFloat(a_vector.y), Fixed::FromFloat(a_vector.z) }; }
+    Vector3f ToVector() const { return Vector3f(x.ToFloat(), y.ToFloat(), z.ToFloat()); }
+
+    constexpr bool operator==(const FixedVector3&) const = default;
+};
+
+// FNV-1a 64 bits sur l'état autoritaire en Q16.16. Le client ne le recalcule pas : il garde celui du dernier snapshot
+// complet reçu et demande un snapshot complet (SnapshotResync) quand un snapshot réduit au hash ne le retrouve pas
+class StateHasher
+{
+public:
+    void AddByte(std::uint8_t a_value)
+    {
+        m_hash ^= a_value;
+        m_hash *= Prime;
+    }
+
+    // Octets dans l'ordre du protocole (big endian)
+    void AddU32(std::uint32_t a_value)
+    {
+        AddByte(static_cast<std::uint8_t>(a_value >> 24));
+        AddByte(static_cast<std::uint8_t>(a_value >> 16));
+        AddByte(static_cast<std::uint8_t>(a_value >> 8));
+        AddByte(static_cast<std::uint8_t>(a_value));
+    }
+
+    void AddFixed(Fixed a_value) { AddU32(static_cast<std::uint32_t>(a_value.raw)); }
+
+    void AddVector(const FixedVector3& a_vector)
+    {
+        AddFixed(a_vector.x);
+        AddFixed(a_vector.y);
+        AddFixed(a_vector.z);
+    }
+
+    // Jamais 0 : 0 signifie "pas de hash" dans les snapshots
+    std::uint64_t Value() const { return m_hash != 0 ? m_hash : 1; }
+
+private:
+    static constexpr std::uint64_t OffsetBasis = 14695981039346656037ull;
+    static constexpr std::uint64_t Prime = 1099511628211ull;
+
+    std::uint64_t m_hash = OffsetBasis;
+};
+
+#endif //_SV_FIXED_HPP
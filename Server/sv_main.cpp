@@ -1,13 +1,41 @@
 #include <enet6/enet.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <csignal>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <variant>
 #include <vector>
 #include <experimental/random>
 
 #include "sv_players.hpp"
+#include "sv_arena.hpp"
+#include "sv_bots.hpp"
+#include "sv_checkpoint.hpp"
+#include "sv_compress.hpp"
 #include "sv_constant.hpp"
+#include "sv_config.hpp"
+#include "sv_control.hpp"
+#include "sv_events.hpp"
+#include "sv_matchmaking.hpp"
+#include "sv_memory.hpp"
+#include "sv_netlink.hpp"
+#include "sv_network.hpp"
 #include "sv_protocol.hpp"
+#include "sv_queue.hpp"
+#include "sv_roster.hpp"
+#include "sv_workers.hpp"
+#include "sv_worldview.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using n_clock = std::chrono::steady_clock;
 
@@ -18,22 +46,87 @@ struct GameData
 {
     GAME_STATE state = GAME_STATE::waiting;
     std::vector<PlayerData> players;
+    const Arena* arena = nullptr;
+
+    std::uint32_t tick = 0; // Tick physique courant
+
+    // Données de la partie en cours : allouées dans l'arène, abandonnées d'un coup à la fin de la partie (reset_match_memory)
+    RoomArena matchArena;
+    std::pmr::vector<SoundSource> sounds{ matchArena.Resource() };      // Sons récents, les plus anciens en premier
+    std::pmr::vector<idSize_t> matchPlayers{ matchArena.Resource() };   // Joueurs placés dans la partie en cours
+    BotNavigation bots;
+
+    EventBus events; // Vidé à chaque tick réseau
+    Roster roster;   // Modifications diffusées à chaque tick réseau
+    Matchmaker matchmaker; // Joueurs connectés en attente d'une partie (match_size > 0)
+
+    std::uint8_t shard = 0; // Listener (ENetHost) qui possède les peers de cette salle
+    std::uint8_t shardCount = 1;
+    bool draining = false; // Commande drain : les nouvelles connexions sont refusées
 };
 
-ENetPacket* build_playerposition_packet(GameData& a_gameData, const PlayerData& a_player, bool a_reliable = false)
+// Vecteur tel que simulé en Q16.16, ou sa valeur flottante si elle a été réécrite depuis (apparition, reprise, joueur non simulé)
+FixedVector3 authoritative_vector(const FixedVector3& a_fixed, const Vector3f& a_value)
 {
-    PlayersPositionPacket packet;
+    Vector3f current = a_fixed.ToVector();
+    if (current.x == a_value.x && current.y == a_value.y && current.z == a_value.z)
+        return a_fixed;
 
-    for (PlayerData& player : a_gameData.players)
+    return FixedVector3::FromVector(a_value);
+}
+
+// Partie commune à tous les destinataires, remplie une fois par tick réseau. Les vectors gardent leur capacité.
+// a_hashState : hash de l'état autoritaire en Q16.16, qui identifie l'état envoyé (voir StateHasher)
+void fill_playerposition_packet(PlayersPositionPacket& a_packet, const GameData& a_gameData, bool a_hashState)
+{
+    a_packet.header.serverTick = a_gameData.tick;
+    a_packet.header.serverTime = get_server_time();
+
+    a_packet.players.clear();
+    for (const PlayerData& player : a_gameData.players)
     {
-        auto& packetPlayer = packet.players.emplace_back();
+        auto& packetPlayer = a_packet.players.emplace_back();
         packetPlayer.id = player.id;
         packetPlayer.position = player.position;
         packetPlayer.velocity = player.velocity;
         packetPlayer.inputs = player.inputs.direction;
     }
 
-    packet.lastInputIndex = a_player.inputs.inputIndex;
+    a_packet.stateHash = 0;
+    if (a_hashState)
+    {
+        StateHasher hasher;
+        for (const PlayerData& player : a_gameData.players)
+        {
+            hasher.AddByte(player.id);
+            hasher.AddVector(authoritative_vector(player.fixedPosition, player.position));
+            hasher.AddVector(authoritative_vector(player.fixedVelocity, player.velocity));
+        }
+        a_packet.stateHash = hasher.Value();
+    }
+}
+
+// Partie propre au destinataire : ses acks d'inputs
+void fill_playerposition_acks(PlayersPositionPacket& a_packet, const PlayerData& a_player, std::uint32_t a_ackWindow)
+{
+    a_packet.lastInputIndex = a_player.inputs.inputIndex;
+
+    const InputAckHistory& history = a_player.inputAcks;
+    std::uint32_t ackCount = std::min(history.count, a_ackWindow);
+    a_packet.firstAckTick = history.lastTick - ackCount + 1;
+
+    a_packet.ackedInputs.clear();
+    for (std::uint32_t tick = a_packet.firstAckTick; ackCount > 0 && tick != history.lastTick + 1; ++tick)
+    {
+        a_packet.ackedInputs.push_back(history.Get(tick));
+    }
+}
+
+ENetPacket* build_playerposition_packet(const GameData& a_gameData, const PlayerData& a_player, std::uint32_t a_ackWindow, bool a_hashState, bool a_reliable = false)
+{
+    thread_local PlayersPositionPacket packet;
+    fill_playerposition_packet(packet, a_gameData, a_hashState);
+    fill_playerposition_acks(packet, a_player, a_ackWindow);
 
     if (a_reliable)
         return build_packet(packet, ENET_PACKET_FLAG_RELIABLE);
@@ -41,245 +134,1354 @@ ENetPacket* build_playerposition_packet(GameData& a_gameData, const PlayerData&
         return build_packet(packet, 0);
 }
 
-void tick_logic(GameData a_gameData, float a_deltaTime)
+// Noyau d'une partition : rôle et mode de physique fixés à la compilation, aucune branche sur eux dans la boucle
+template<PLAYER_ROLE Role, bool FixedPoint>
+void simulate_partition(std::span<PlayerData* const> a_players, std::uint32_t a_tick, std::uint32_t a_now, const Arena& a_arena, const PhysicsSettings& a_physics, std::pmr::vector<SoundSource>& a_sounds, EventBus& a_events, float a_deltaTime)
 {
-    for (PlayerData player : a_gameData.players)
+    RolePhysics role = a_physics.For<Role>();
+    FixedRolePhysics fixedRole = FixedRolePhysics::From(a_physics, role);
+    Fixed fixedDeltaTime = Fixed::FromFloat(a_deltaTime);
+
+    for (PlayerData* player : a_players)
     {
-        if (!player.name.empty())
+        bool wasRising = player->velocity.y > 0.0f;
+
+        if constexpr (FixedPoint)
+            UpdatePhysicsFixed<Role>(*player, a_physics, fixedRole, a_arena, fixedDeltaTime);
+        else
+            UpdatePhysics<Role>(*player, a_physics, role, a_arena, a_deltaTime);
+
+        // Un humain qui saute fait du bruit
+        if constexpr (Role == PLAYER_ROLE::human)
         {
-            UpdatePhysics(player, a_deltaTime);
+            if (!wasRising && player->velocity.y > 0.0f)
+            {
+                a_sounds.push_back({ player->position, a_now });
+                a_events.EmitSound(player->id, player->position);
+            }
         }
+
+        if (!player->isBot)
+            player->inputAcks.Record(a_tick, player->inputs.inputIndex);
+    }
+}
+
+void simulate_players(PlayerSpan a_players, std::uint32_t a_tick, std::uint32_t a_now, const Arena& a_arena, const PhysicsSettings& a_physics, std::pmr::vector<SoundSource>& a_sounds, EventBus& a_events, float a_deltaTime)
+{
+    // Joueurs répartis par rôle à chaque tick (un ver peut changer de rôle), l'ordre de la salle est conservé dans chaque partition
+    thread_local std::vector<PlayerData*> humans;
+    thread_local std::vector<PlayerData*> worms;
+    humans.clear();
+    worms.clear();
+
+    for (PlayerData& player : a_players)
+    {
+        if (player.name.empty())
+            continue;
+
+        if (player.Role() == PLAYER_ROLE::worm)
+            worms.push_back(&player);
+        else
+            humans.push_back(&player);
     }
-} 
 
-void tick_network(GameData a_gameData, float a_deltaTime)
+    if (a_physics.fixedPoint)
+    {
+        simulate_partition<PLAYER_ROLE::human, true>(humans, a_tick, a_now, a_arena, a_physics, a_sounds, a_events, a_deltaTime);
+        simulate_partition<PLAYER_ROLE::worm, true>(worms, a_tick, a_now, a_arena, a_physics, a_sounds, a_events, a_deltaTime);
+    }
+    else
+    {
+        simulate_partition<PLAYER_ROLE::human, false>(humans, a_tick, a_now, a_arena, a_physics, a_sounds, a_events, a_deltaTime);
+        simulate_partition<PLAYER_ROLE::worm, false>(worms, a_tick, a_now, a_arena, a_physics, a_sounds, a_events, a_deltaTime);
+    }
+}
+
+// Modifie la salle en place : aucune copie ni allocation pendant le tick
+void tick_logic(GameData& a_gameData, const PhysicsSettings& a_physics, float a_deltaTime)
+{
+    ++a_gameData.tick;
+    std::uint32_t now = get_server_time();
+
+    auto expired = std::find_if(a_gameData.sounds.begin(), a_gameData.sounds.end(), [&](const SoundSource& sound) { return now - sound.time <= static_cast<std::uint32_t>(SoundLifetime); });
+    a_gameData.sounds.erase(a_gameData.sounds.begin(), expired);
+
+    UpdateBots(a_gameData.bots, a_gameData.players, a_gameData.sounds, a_gameData.tick, now);
+
+    simulate_players(a_gameData.players, a_gameData.tick, now, *a_gameData.arena, a_physics, a_gameData.sounds, a_gameData.events, a_deltaTime);
+}
+
+// Recopie la salle dans le tampon libre de a_buffer puis le publie. Appelé par le thread de simulation après chaque tick
+void publish_world_view(WorldViewBuffer& a_buffer, const GameData& a_gameData)
 {
+    WorldView& view = a_buffer.Back();
+    view.tick = a_gameData.tick;
+    view.serverTime = get_server_time();
+    view.state = a_gameData.state;
+
+    view.players.clear();
     for (const PlayerData& player : a_gameData.players)
+    {
+        if (player.name.empty())
+            continue;
+
+        view.players.push_back({ player.id, player.name, player.state, player.position, player.velocity, player.inputs.direction, player.isBot, player.peer != nullptr });
+    }
+
+    a_buffer.Publish();
+}
+
+#pragma region Sessions
+
+// L'octet de poids fort porte le shard de la salle : un client qui revient sur un autre shard est renvoyé tenter sa chance
+std::uint64_t generate_session_token(std::uint8_t a_shard)
+{
+    // random_device ne donne que 32 bits par tirage : plusieurs tirages pour que l'état initial ne se devine pas
+    thread_local std::mt19937_64 generator = []()
+    {
+        std::random_device device;
+        std::seed_seq seed{ device(), device(), device(), device(), device(), device(), device(), device() };
+        return std::mt19937_64(seed);
+    }();
+
+    std::uint64_t token;
+    do
+    {
+        token = generator() & ((std::uint64_t(1) << SessionTokenShardShift) - 1);
+    } while (token == 0); // 0 = pas de session
+
+    return token | (static_cast<std::uint64_t>(a_shard) << SessionTokenShardShift);
+}
+
+// Joueur coupé dont la place attend encore une reconnexion
+bool is_session_reserved(const PlayerData& a_player, std::uint32_t a_now, std::uint32_t a_gracePeriod)
+{
+    return a_player.peer == nullptr && !a_player.isBot && !a_player.name.empty() && a_player.sessionToken != 0
+        && a_now - a_player.disconnectTime < a_gracePeriod;
+}
+
+// Libère les places dont la période de grâce est écoulée
+void expire_sessions(GameData& a_gameData, std::uint32_t a_now, std::uint32_t a_gracePeriod)
+{
+    for (PlayerData& player : a_gameData.players)
+    {
+        if (player.peer != nullptr || player.isBot || player.name.empty() || is_session_reserved(player, a_now, a_gracePeriod))
+            continue;
+
+        std::cout << "Player #" << static_cast<int>(player.id) << " [" << player.name << "] session expired\n" << std::flush;
+        player.name.clear();
+        a_gameData.roster.Leave(player.id);
+        player.sessionToken = 0;
+    }
+}
+
+// Le joueur perd son peer : il reste dans la partie, immobile, si sa session peut être reprise
+void detach_player(PlayerData& a_player, GameData& a_gameData, const ServerConfig& a_config)
+{
+    a_player.peer = nullptr;
+    a_gameData.matchmaker.Remove(a_player.id); // Remis dans la file s'il reprend sa session
+
+    if (!a_player.name.empty() && a_config.sessionGracePeriod > 0)
+    {
+        a_player.disconnectTime = get_server_time();
+        a_player.inputs.direction = Vector2f::Zero();
+        a_player.inputs.jump = false;
+        a_player.inputs.interact = false;
+    }
+    else
+    {
+        if (!a_player.name.empty())
+            a_gameData.roster.Leave(a_player.id);
+
+        a_player.name.clear();
+        a_player.sessionToken = 0;
+    }
+}
+
+// Coupé sans reprise possible : la place est libérée tout de suite
+void kick_player(PlayerData& a_player, GameData& a_gameData)
+{
+    disconnect_peer(a_player, static_cast<enet_uint32>(DISCONNECT_REASON::Kicked));
+    a_gameData.matchmaker.Remove(a_player.id);
+
+    if (!a_player.name.empty())
+        a_gameData.roster.Leave(a_player.id);
+
+    a_player.name.clear();
+    a_player.sessionToken = 0;
+    a_player.disconnectTime = 0;
+}
+
+void send_game_data(PlayerData& a_player, const ServerConfig& a_config)
+{
+    GameDataPacket gameDataPacket;
+    gameDataPacket.playerId = a_player.id;
+    gameDataPacket.logicTickRate = static_cast<std::uint16_t>(a_config.logicTickRate);
+    gameDataPacket.networkTickRate = static_cast<std::uint16_t>(a_config.networkTickRate);
+    gameDataPacket.capabilities = a_player.capabilities;
+    gameDataPacket.sessionToken = a_player.sessionToken;
+
+    send_packet(a_player, gameDataPacket);
+}
+
+// Liste complète à la version courante : à l'arrivée, à la reprise de session ou si le client s'est désynchronisé
+void send_player_list(PlayerData& a_player, const GameData& a_gameData, const ServerConfig& a_config)
+{
+    thread_local PlayerListPacket packet;
+    thread_local PacketBundler bundler;
+    a_gameData.roster.FillPlayerList(packet, a_gameData.players);
+
+    // Plus gros message fiable d'une salle pleine : passe par le bundler pour être compressé si le client le gère
+    bundler.Begin(a_player, a_config.compressionThreshold);
+    bundler.Add(packet);
+    bundler.Flush();
+}
+
+// Rattache la connexion a_connection (place temporaire) au joueur a_player resté dans la partie
+void resume_session(PlayerData& a_connection, PlayerData& a_player, GameData& a_gameData, const ServerConfig& a_config)
+{
+    a_player.peer = a_connection.peer;
+    a_player.connection = a_connection.connection;
+    a_player.mtu = a_connection.mtu;
+    a_player.channelCount = a_connection.channelCount;
+    a_player.capabilities = a_connection.capabilities;
+    a_player.roundTripTime = a_connection.roundTripTime;
+    a_player.sendBudget = 0;
+    a_player.inputAcks.Reset();
+    a_player.disconnectTime = 0;
+    a_player.lastSnapshotHash = 0;
+    a_player.unchangedSnapshots = 0;
+
+    a_connection.peer = nullptr;
+    a_connection.capabilities = 0;
+
+    std::cout << "Player #" << static_cast<int>(a_player.id) << " [" << a_player.name << "] resumed its session (from slot #" << static_cast<int>(a_connection.id) << ")\n" << std::flush;
+
+    // Sorti de la file à la coupure, il la reprend en dernier
+    if (a_player.state == PLAYER_STATE::waiting && a_config.matchSize > 0)
+        a_gameData.matchmaker.Enqueue(a_player.id, a_player.partyId, a_player.roundTripTime, get_server_time(), a_config.matchRttBucket);
+
+    send_game_data(a_player, a_config);
+    send_player_list(a_player, a_gameData, a_config);
+
+    // Un seul snapshot complet et fiable, les suivants reprennent le flux normal
+    send_to_player(a_player, PlayersPositionPacket::channel, build_playerposition_packet(a_gameData, a_player, 0, a_config.physics.fixedPoint, true), SEND_PRIORITY::Critical);
+}
+
+#pragma endregion
+
+// Buffers d'un worker d'encodage, réutilisés d'un tick réseau à l'autre
+struct alignas(CacheLineSize) SnapshotScratch
+{
+    PlayersPositionPacket packet;
+    PlayersPositionPacket unchanged; // Même en-tête et même hash, sans les joueurs
+    PacketBundler bundler;
+    std::uint32_t round = 0; // Tick réseau dont packet contient la partie commune
+};
+
+// Encodage des envois d'un tick réseau, réparti sur les workers. Possédé par le thread de simulation
+struct SnapshotEncoder
+{
+    WorkerPool pool;
+    PlayersPositionPacket shared;           // Partie commune, remplie par le thread de simulation et lue par tous les workers
+    std::vector<SnapshotScratch> scratch;   // Un par worker
+    std::vector<PlayerData*> recipients;
+    std::vector<std::vector<PendingPacket>> pending; // Packets de recipients[i], gardent leur capacité
+    std::uint32_t round = 0;
+
+    std::uint64_t encodeNanoseconds = 0; // Depuis le dernier log
+    std::uint32_t encodeCount = 0;
+};
+
+void tick_network(GameData& a_gameData, SnapshotEncoder& a_encoder, const ServerConfig& a_config, float a_deltaTime)
+{
+    // Ticks physiques par tick réseau, avec de la redondance pour les snapshots perdus
+    std::uint32_t ticksPerSnapshot = static_cast<std::uint32_t>((a_config.logicTickRate + a_config.networkTickRate - 1) / a_config.networkTickRate);
+    std::uint32_t ackWindow = std::min<std::uint32_t>(ticksPerSnapshot * InputAckRedundancy, InputAckHistorySize);
+
+    const PlayersPositionPacket& packet = a_encoder.shared;
+    fill_playerposition_packet(a_encoder.shared, a_gameData, a_config.physics.fixedPoint);
+
+    expire_sessions(a_gameData, get_server_time(), a_config.sessionGracePeriod);
+
+    a_encoder.recipients.clear();
+    for (PlayerData& player : a_gameData.players)
     {
         if (player.peer != nullptr && !player.name.empty())
+            a_encoder.recipients.push_back(&player);
+    }
+
+    if (a_encoder.pending.size() < a_encoder.recipients.size())
+        a_encoder.pending.resize(a_encoder.recipients.size());
+    a_encoder.scratch.resize(a_encoder.pool.WorkerCount());
+    ++a_encoder.round;
+
+    std::chrono::time_point encodeStart = n_clock::now();
+
+    // Le thread de simulation attend les workers : la salle ne bouge pas pendant l'encodage.
+    // Chaque destinataire n'est modifié (budget) que par le worker qui l'encode
+    a_encoder.pool.ParallelFor(a_encoder.recipients.size(), [&](std::size_t a_worker, std::size_t a_index)
+    {
+        SnapshotScratch& scratch = a_encoder.scratch[a_worker];
+        if (scratch.round != a_encoder.round)
         {
-            ENetPacket* packet = build_playerposition_packet(a_gameData, player);
-			enet_peer_send(player.peer, 0, packet);
+            scratch.packet.header = packet.header;
+            scratch.packet.stateHash = packet.stateHash;
+            scratch.packet.players = packet.players;
+            scratch.unchanged.header = packet.header;
+            scratch.unchanged.stateHash = packet.stateHash;
+            scratch.round = a_encoder.round;
         }
-    }
+
+        PlayerData& player = *a_encoder.recipients[a_index];
+
+        refill_send_budget(player, a_config.peerBandwidth, a_deltaTime);
+        scratch.bundler.Begin(player, a_config.compressionThreshold, &a_encoder.pending[a_index]);
+
+        // Arrivées, départs et renommages du tick, fiables : avant tout le reste
+        if (a_gameData.roster.HasChanges())
+            scratch.bundler.Add(a_gameData.roster.Update());
+
+        // Les snapshots passent après le trafic fiable, on ne les construit pas si le budget est épuisé
+        if (has_send_budget(player))
+        {
+            // Même hash que le dernier snapshot complet de ce joueur : il a déjà cet état, le hash lui suffit pour le vérifier.
+            // Si ce complet a été perdu, le client le voit au hash suivant et demande une correction (SnapshotResync) ;
+            // un complet repart quand même régulièrement
+            bool unchanged = packet.stateHash != 0 && packet.stateHash == player.lastSnapshotHash && player.unchangedSnapshots < SnapshotKeyframeInterval;
+            PlayersPositionPacket& snapshot = unchanged ? scratch.unchanged : scratch.packet;
+
+            fill_playerposition_acks(snapshot, player, ackWindow);
+            scratch.bundler.Add(snapshot);
+
+            if (unchanged)
+            {
+                ++player.unchangedSnapshots;
+            }
+            else
+            {
+                player.lastSnapshotHash = packet.stateHash;
+                player.unchangedSnapshots = 0;
+            }
+        }
+
+        // Événements du tick : un envoi groupé par destinataire, quel que soit le nombre d'émissions
+        a_gameData.events.Flush(player, scratch.bundler);
+
+        // Un datagramme par canal pour tout le tick
+        scratch.bundler.Flush();
+    });
+
+    a_encoder.encodeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(n_clock::now() - encodeStart).count();
+    ++a_encoder.encodeCount;
+
+    // Envoyés par ce thread, seul producteur de la file vers le thread réseau, dans l'ordre des joueurs
+    for (std::size_t i = 0; i < a_encoder.recipients.size(); ++i)
+        send_pending_packets(*a_encoder.recipients[i], a_encoder.pending[i]);
+
+    a_gameData.events.Clear();
+    a_gameData.roster.Clear();
 }
 
-void handle_message(PlayerData& player, const byteArray_t& message, GameData& gameData)
+// Message déjà décodé par le thread réseau
+void handle_message(PlayerData& player, NetMessage& message, GameData& gameData, const ServerConfig& config)
 {
-    std::size_t offset = 0;
-    
-    OP_CODE opcode = static_cast<OP_CODE>(Deserialize_u8(message, offset));
-    //std::cout << "Handle Message - opcode : " << static_cast<int>(opcode) << "\n" << std::flush;
-    if (player.name.empty() && opcode != OP_CODE::C_PlayerInfo)
+    if (player.name.empty() && !std::holds_alternative<PlayerInfoPacket>(message))
     {
-        enet_peer_disconnect_now(player.peer, 0);
-        player.peer = nullptr;
+        disconnect_peer(player, 0);
         std::cout << "Player #" << player.id << " did not sent PlayerInfo packet as intented!\nDisconnecting player\n" << std::flush;
         return;
     }
 
-    switch (opcode)
+    if (PlayerInfoPacket* info = std::get_if<PlayerInfoPacket>(&message))
     {
-        case OP_CODE::C_PlayerInfo:
+        PlayerInfoPacket& packet = *info;
+
+        if (packet.name.size() > config.playerNameLength)
         {
-            PlayerInfoPacket packet = PlayerInfoPacket::Deserialize(message, offset);
+            packet.name.resize(config.playerNameLength);
+        }
+        if (packet.name.empty())
+        {
+            std::cout << "Player #" << player.id << " tried renaming itself, but given name is empty!\n" << std::flush;
 
-            if (packet.name.size() > MaxPlayerNameLength)
+            if (player.name.empty())
             {
-                packet.name.resize(MaxPlayerNameLength);
+                disconnect_peer(player, 0);
+                std::cout << "Player #" << player.id << " did not sent a correct name!\nDisconnecting player\n" << std::flush;
             }
-            if (packet.name.empty())
+
+            return;
+        }
+
+        // Le serveur ne retient que ce qu'il gère lui-même
+        std::uint8_t supported = config.compressionThreshold > 0 ? CAPABILITY_Compression : 0;
+        player.capabilities = packet.capabilities & supported;
+
+        std::uint64_t tokenShard = packet.sessionToken >> SessionTokenShardShift;
+        if (player.name.empty() && packet.sessionToken != 0 && tokenShard != gameData.shard && tokenShard < gameData.shardCount)
+        {
+            // Le shard est choisi par l'adresse source (attach_shard_selector) : on n'arrive ici que si elle a changé ou sans filtre.
+            // Le noyau répartit alors par adresse + port : en se reconnectant depuis un autre port, il retombera peut-être sur sa salle
+            disconnect_peer(player, static_cast<enet_uint32>(DISCONNECT_REASON::Retry));
+            return;
+        }
+
+        if (player.name.empty() && packet.sessionToken != 0)
+        {
+            std::uint32_t now = get_server_time();
+            // Coupure courte : le client revient avant qu'ENet n'ait fait expirer son ancien peer, qui est alors encore attaché
+            auto it = std::find_if(gameData.players.begin(), gameData.players.end(), [&](const PlayerData& other)
             {
-                std::cout << "Player #" << player.id << " tried renaming itself, but given name is empty!\n" << std::flush;
+                return &other != &player && other.sessionToken == packet.sessionToken && !other.isBot && !other.name.empty()
+                    && (other.peer != nullptr || is_session_reserved(other, now, config.sessionGracePeriod));
+            });
 
-                if (player.name.empty())
+            if (it != gameData.players.end())
+            {
+                if (it->peer != nullptr)
                 {
-                    enet_peer_disconnect_now(player.peer, 0);
-                    player.peer = nullptr;
-                    std::cout << "Player #" << player.id << " did not sent a correct name!\nDisconnecting player\n" << std::flush;
+                    std::cout << "Player #" << static_cast<int>(it->id) << " [" << it->name << "] reconnected before its old connection timed out, dropping it\n" << std::flush;
+                    disconnect_peer(*it, static_cast<enet_uint32>(DISCONNECT_REASON::None));
                 }
 
-                break;
+                // player n'a plus de peer : les commandes suivantes de cette connexion vont au joueur repris
+                resume_session(player, *it, gameData, config);
+                return;
             }
 
-            if (player.name.empty())
-            {
-                player.name = packet.name;
-                std::cout << "Player #" << player.id << " joined as " << player.name << "\n" << std::flush;
+            std::cout << "Player #" << player.id << " sent an unknown or expired session token, starting a new session\n" << std::flush;
+        }
 
-                GameDataPacket gameDataPacket;
-                gameDataPacket.playerId = player.id;
+        if (player.name.empty())
+        {
+            player.name.assign(packet.name);
+            player.sessionToken = generate_session_token(gameData.shard);
+            player.disconnectTime = 0;
+            player.partyId = packet.partyId;
+            gameData.roster.Join(player.id, player.name.view());
+            std::cout << "Player #" << player.id << " joined as " << player.name << "\n" << std::flush;
 
-                enet_peer_send(player.peer, 0, build_packet(gameDataPacket, ENET_PACKET_FLAG_RELIABLE));
-            }
-            else
+            if (config.matchSize > 0)
             {
-                player.name = packet.name;
-                std::cout << "Player #" << player.id << " renamed itself as " << player.name << "\n" << std::flush;
+                player.state = PLAYER_STATE::waiting;
+                gameData.matchmaker.Enqueue(player.id, player.partyId, player.roundTripTime, get_server_time(), config.matchRttBucket);
             }
-            break;
+
+            send_game_data(player, config);
+            send_player_list(player, gameData, config);
         }
-        case OP_CODE::C_PlayerInput:
+        else
         {
-            PlayerInputPacket packet = PlayerInputPacket::Deserialize(message, offset);
-
-            player.inputs = packet.inputs;
+            player.name.assign(packet.name);
+            gameData.roster.Rename(player.id, player.name.view());
+            std::cout << "Player #" << player.id << " renamed itself as " << player.name << "\n" << std::flush;
         }
+    }
+    else if (PlayerInputPacket* input = std::get_if<PlayerInputPacket>(&message))
+    {
+        // Le canal input n'est pas séquencé, on ignore un input plus ancien que celui en cours
+        if (input->inputs.inputIndex >= player.inputs.inputIndex)
+            player.inputs = input->inputs;
+    }
+    else if (TimeSyncRequestPacket* timeSync = std::get_if<TimeSyncRequestPacket>(&message))
+    {
+        TimeSyncResponsePacket response;
+        response.clientTime = timeSync->clientTime;
+        response.header.serverTick = gameData.tick;
+        response.header.serverTime = get_server_time();
 
-        case OP_CODE::Unexpected:
-        default:
-            std::cerr << "Handle Message : Unexpected opcode (" << static_cast<int>(opcode) <<")\n" << std::flush;
-            break;
+        send_packet(player, response);
+    }
+    else if (RosterResyncPacket* resync = std::get_if<RosterResyncPacket>(&message))
+    {
+        std::cout << "Player #" << player.id << " asked for the player list (roster " << resync->rosterVersion << ", current " << gameData.roster.Version() << ")\n" << std::flush;
+        send_player_list(player, gameData, config);
+    }
+    else if (SnapshotResyncPacket* resync = std::get_if<SnapshotResyncPacket>(&message))
+    {
+        // Un complet est déjà prévu au prochain tick réseau : une seule correction par tick, même si le client insiste
+        if (player.lastSnapshotHash == 0)
+            return;
+
+        std::cout << "Player #" << player.id << " missed the state of tick " << resync->serverTick << ", sending a full snapshot\n" << std::flush;
+
+        // Correction fiable, l'écart est probablement dû à un complet perdu. Le prochain tick repart d'un complet
+        send_to_player(player, PlayersPositionPacket::channel, build_playerposition_packet(gameData, player, 0, config.physics.fixedPoint, true), SEND_PRIORITY::Critical);
+        player.lastSnapshotHash = 0;
+        player.unchangedSnapshots = 0;
+    }
+    else if (NetUnexpected* unexpected = std::get_if<NetUnexpected>(&message))
+    {
+        std::cerr << "Handle Message : Unexpected opcode (" << static_cast<int>(unexpected->opcode) <<")\n" << std::flush;
     }
 }
 
-int main(int argc, char** argv)
+void apply_command(GameData& gameData, NetCommand& command, const ServerConfig& config)
 {
-    enet_uint16 port;
-    if (argc != 2)
+    if (NetConnect* connect = std::get_if<NetConnect>(&command.message))
     {
-        port = (enet_uint16)std::experimental::randint(minPort, maxPort);
-        std::cout << "No port given, random port assigned...\n" << std::flush;
+        // Les places réservées à une reconnexion restent prises jusqu'à expiration
+        auto it = std::find_if(gameData.players.begin(), gameData.players.end(), [&](const PlayerData& player) { return player.peer == nullptr && !player.isBot && player.name.empty(); });
+        if (it == gameData.players.end()) // Pas de Slot libre
+        {
+            gameData.players.emplace_back((idSize_t)gameData.players.size());
+            it = gameData.players.end() - 1; // Set l'itérateur sur le nouvelle élément
+        }
+
+        PlayerData& player = *it;
+        player.peer = command.peer; // Association du joueur à son peer
+        player.connection = command.connection;
+        player.mtu = connect->mtu;
+        player.channelCount = connect->channelCount;
+        player.roundTripTime = command.roundTripTime;
+        player.partyId = 0;
+        player.sendBudget = 0;
+        player.inputs = PlayerInputs();
+        player.inputAcks.Reset();
+        player.capabilities = 0;
+        player.lastSnapshotHash = 0;
+        player.unchangedSnapshots = 0;
+
+        player.name.clear();
+        player.state = PLAYER_STATE::connecting;
+
+        if (gameData.draining)
+        {
+            disconnect_peer(player, static_cast<enet_uint32>(DISCONNECT_REASON::Draining));
+            std::cout << "Player #" << static_cast<int>(player.id) << " refused, shard " << static_cast<int>(gameData.shard) << " is draining\n" << std::flush;
+            return;
+        }
+
+        std::cout << "Player #" << static_cast<int>(player.id) << " Connected! " << "\n" << std::flush;
+        return;
     }
-    else
+
+    // Introuvable : la simulation a déjà coupé cette connexion
+    auto it = std::find_if(gameData.players.begin(), gameData.players.end(), [&](const PlayerData& player) { return player.peer == command.peer && player.connection == command.connection; });
+    if (it == gameData.players.end())
+        return;
+
+    PlayerData& player = *it;
+    player.roundTripTime = command.roundTripTime;
+    gameData.matchmaker.UpdateLatency(player.id, player.roundTripTime, config.matchRttBucket);
+
+    if (NetDisconnect* disconnect = std::get_if<NetDisconnect>(&command.message))
     {
-        port = (enet_uint16)std::atoi(argv[1]);
+        std::cout << "Player #" << static_cast<int>(player.id) << " [" << player.name << "] disconnected ";
+        if (disconnect->timeout)
+            std::cout << "(time out)";
+        std::cout << "\n" << std::flush;
+
+        detach_player(player, gameData, config);
+
+        if (!player.name.empty())
+        {
+            //Envoyer le message aux autres joueurs
+        }
+
+        //Check l'état du jeu / s'il y a encore des joueurs connecté
+        return;
     }
 
-    if (enet_initialize() != 0)
+    handle_message(player, command.message, gameData, config);
+}
+
+#pragma region Matchmaking
+
+// Les conteneurs de la partie rendent leur mémoire avant que l'arène ne soit vidée d'un coup
+void reset_match_memory(GameData& a_gameData)
+{
+    a_gameData.sounds = std::pmr::vector<SoundSource>(a_gameData.matchArena.Resource());
+    a_gameData.matchPlayers = std::pmr::vector<idSize_t>(a_gameData.matchArena.Resource());
+    a_gameData.matchArena.Reset();
+}
+
+// Joueur de la partie en cours : hors bots et hors file d'attente
+bool is_match_player(const PlayerData& a_player)
+{
+    return !a_player.isBot && !a_player.name.empty()
+        && (a_player.state == PLAYER_STATE::human || a_player.state == PLAYER_STATE::worm || a_player.state == PLAYER_STATE::dead);
+}
+
+// Un camp n'a plus personne : plus d'humain en vie ou plus de ver
+bool is_match_over(const GameData& a_gameData)
+{
+    bool humans = false;
+    bool worms = false;
+    for (const PlayerData& player : a_gameData.players)
     {
-        std::cout << "Failed to initialize ENet\n" << std::flush;
-        return EXIT_FAILURE;
+        if (!is_match_player(player))
+            continue;
+
+        humans |= player.state == PLAYER_STATE::human;
+        worms |= player.state == PLAYER_STATE::worm;
     }
 
-    //création hôte server
-    ENetAddress address;
-    ENetHost* host;
+    return !humans || !worms;
+}
 
-    enet_address_build_any(&address, ENET_ADDRESS_TYPE_IPV6);
-    address.port = port;
+void start_match(GameData& a_gameData)
+{
+    std::span<const idSize_t> match = a_gameData.matchPlayers;
 
+    GameStartStatePacket packet;
+    packet.header.serverTick = a_gameData.tick;
+    packet.header.serverTime = get_server_time();
+    packet.countdown = 0;
 
-    host = enet_host_create(ENET_ADDRESS_TYPE_ANY, &address, 16, 0, 0, 0);
-    if (!host)
+    std::uint32_t worstRoundTrip = 0;
+    for (std::size_t i = 0; i < match.size(); ++i)
     {
-        std::cerr << "Failed to create ENet host\n" << std::flush;
-		return EXIT_FAILURE;
-    }
+        PlayerData& player = a_gameData.players[match[i]];
+        player.state = (i % MatchWormRatio == 0) ? PLAYER_STATE::worm : PLAYER_STATE::human;
+        worstRoundTrip = std::max(worstRoundTrip, player.roundTripTime);
 
-    std::cout << "Server creation success!\n" << std::flush;
-    std::cout << "Port : " << port << "\n" << std::flush;
+        packet.players.push_back({ player.id, player.position, static_cast<std::uint8_t>(player.state) });
+    }
 
-    GameData gameData;
+    for (idSize_t id : match)
+        send_packet(a_gameData.players[id], packet);
 
-    //Init clock
-    std::chrono::time_point lastTickLogic = n_clock::now();
-    std::chrono::time_point lastTickNetwork = n_clock::now();
+    a_gameData.state = GAME_STATE::game;
+    std::cout << "Shard " << static_cast<int>(a_gameData.shard) << " match started : " << match.size() << " players, worst RTT " << worstRoundTrip << " ms, "
+        << a_gameData.matchmaker.QueuedPlayers() << " still waiting\n" << std::flush;
+}
 
-    std::chrono::milliseconds LogicTickRate = std::chrono::milliseconds(TICK_LOGIC_DELAY);
-    std::chrono::milliseconds NetworkTickRate = std::chrono::milliseconds(TICK_NETWORK_DELAY);
+// Les joueurs de la partie repartent dans la file, avec leur groupe
+void finish_match(GameData& a_gameData, const ServerConfig& a_config)
+{
+    FinishedStatePacket packet;
+    packet.header.serverTick = a_gameData.tick;
+    packet.header.serverTime = get_server_time();
 
-    std::cout << "Starting Server loop...\n" << std::flush;
-    while (true)
+    for (idSize_t id : a_gameData.matchPlayers)
     {
-        std::chrono::time_point now = n_clock::now();
-        
-        ENetEvent event;
-        if (enet_host_service(host, &event, 1) > 0)
-        {
-            do
-            {
-                // std::cout << "Packet received\n" << std::flush;
+        const PlayerData& player = a_gameData.players[id];
+        if (is_match_player(player))
+            packet.players.push_back({ player.id, std::string(player.name.view()) });
+    }
 
-                switch (event.type)
-                {
-                    case ENET_EVENT_TYPE_CONNECT:
-                    {
-                        auto it = std::find_if(gameData.players.begin(), gameData.players.end(), [&](const PlayerData& player) { return player.peer == nullptr; });
-                        if (it == gameData.players.end()) // Pas de Slot libre
-                        {
-                            gameData.players.emplace_back((idSize_t)gameData.players.size());
-                            it = gameData.players.end() - 1; // Set l'itérateur sur le nouvelle élément
-                        }
-
-                        PlayerData& player = *it;
-                        player.peer = event.peer; // Association du joueur à son peer
-
-                        player.name.clear();
-                        player.state = PLAYER_STATE::connecting;
-                        std::cout << "Player #" << static_cast<int>(player.id) << " Connected! " << "\n" << std::flush;
-                        break;
-                    }
-                    case ENET_EVENT_TYPE_DISCONNECT:
-					case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
-					{
-                        auto it = std::find_if(gameData.players.begin(), gameData.players.end(), [&](const PlayerData& player) { return player.peer == event.peer; });
-                        if (it == gameData.players.end())
-                        {
-                            break;
-                        }
-
-                        PlayerData& player = *it;
-
-                        std::cout << "Player #" << static_cast<int>(player.id) << " [" << player.name << "] disconnected ";
-                        if (event.type == ENET_EVENT_TYPE_DISCONNECT_TIMEOUT)
-                            std::cout << "(time out)";
-                        std::cout << "\n" << std::flush;
-
-                        player.peer = nullptr;
-
-                        if (!player.name.empty())
-                        {
-                            //Envoyer le message aux autres joueurs
-                        }
-
-                        //Check l'état du jeu / s'il y a encore des joueurs connecté
-
-                        break;
-                    }
-                    case ENET_EVENT_TYPE_RECEIVE:
-                    {
-                        auto it = std::find_if(gameData.players.begin(), gameData.players.end(), [&](const PlayerData& player) { return player.peer == event.peer; });
-                        if (it == gameData.players.end())
-                        {
-                            break;
-                        }
-
-                        PlayerData& player = *it;
-
-                        byteArray_t content(event.packet->dataLength);
-                        std::memcpy(content.data(), event.packet->data, event.packet->dataLength);
-
-                        handle_message(player, content, gameData);
-
-                        enet_packet_destroy(event.packet);
-                        break;
-                    }
-                    case ENET_EVENT_TYPE_NONE:
-                    default:
-                    {
-						// n'est pas censé se produire
-						std::cout << "unexpected ENet event\n" << std::flush;
-						break;
-                    }
-                }
-            } while (enet_host_check_events(host, &event) > 0);
-        } 
-        
-        auto deltaLogic = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTickLogic);
-        if (deltaLogic >= LogicTickRate)
-        {
-            tick_logic(gameData, std::chrono::duration<float>(deltaLogic).count());
+    for (idSize_t id : a_gameData.matchPlayers)
+    {
+        PlayerData& player = a_gameData.players[id];
+        if (!is_match_player(player))
+            continue;
 
-            lastTickLogic = now;
-        }
+        player.state = PLAYER_STATE::waiting;
 
-        auto deltaNetwork = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTickLogic);
-        if (deltaNetwork >= NetworkTickRate)
-        {
-            tick_network(gameData, std::chrono::duration<float>(deltaNetwork).count());
+        // Coupé : remis dans la file à la reprise de sa session
+        if (player.peer == nullptr)
+            continue;
 
-            lastTickLogic = now;
-        }
+        send_packet(player, packet);
+        if (a_config.matchSize > 0)
+            a_gameData.matchmaker.Enqueue(player.id, player.partyId, player.roundTripTime, packet.header.serverTime, a_config.matchRttBucket);
     }
-}
\ No newline at end of file
+
+    a_gameData.state = GAME_STATE::waiting;
+    reset_match_memory(a_gameData);
+    std::cout << "Shard " << static_cast<int>(a_gameData.shard) << " match finished, " << packet.players.size() << " players back in the queue\n" << std::flush;
+}
+
+// Tick logique, avant la simulation : termine la partie en cours ou en forme une depuis la file
+void update_matchmaking(GameData& a_gameData, const ServerConfig& a_config)
+{
+    if (a_gameData.state == GAME_STATE::game)
+    {
+        if (!is_match_over(a_gameData))
+            return;
+
+        finish_match(a_gameData, a_config);
+    }
+
+    if (a_config.matchSize == 0 || a_gameData.draining)
+        return;
+
+    if (a_gameData.matchmaker.FormMatch(a_gameData.matchPlayers, a_config.matchSize, get_server_time(), a_config.matchMaxWait))
+        start_match(a_gameData);
+}
+
+#pragma endregion
+
+#pragma region Admin
+
+// Thread de simulation, entre deux ticks : le thread de contrôle ne fait que déposer la commande
+void apply_admin_command(GameData& a_gameData, const AdminCommand& a_command)
+{
+    int shard = static_cast<int>(a_gameData.shard);
+
+    switch (a_command.op)
+    {
+        case ADMIN_OP::Kick:
+        {
+            auto it = std::find_if(a_gameData.players.begin(), a_gameData.players.end(), [&](const PlayerData& player) { return player.id == a_command.player; });
+            if (it == a_gameData.players.end() || it->isBot || (it->peer == nullptr && it->name.empty()))
+            {
+                std::cerr << "ERROR -> apply_admin_command : No player #" << static_cast<int>(a_command.player) << " in shard " << shard << "\n" << std::flush;
+                return;
+            }
+
+            std::cout << "Player #" << static_cast<int>(it->id) << " [" << it->name << "] kicked from shard " << shard << "\n" << std::flush;
+            kick_player(*it, a_gameData);
+            break;
+        }
+
+        case ADMIN_OP::Reset:
+        {
+            // Nouvelle salle sur le même listener : les bots restent, les joueurs sont coupés et leurs places libérées
+            std::size_t kicked = 0;
+            for (PlayerData& player : a_gameData.players)
+            {
+                if (player.isBot || (player.peer == nullptr && player.name.empty()))
+                    continue;
+
+                kick_player(player, a_gameData);
+                ++kicked;
+            }
+
+            a_gameData.state = GAME_STATE::waiting;
+            reset_match_memory(a_gameData);
+            std::cout << "Shard " << shard << " room reset, " << kicked << " players kicked\n" << std::flush;
+            break;
+        }
+
+        case ADMIN_OP::Drain:
+            a_gameData.draining = true;
+            std::cout << "Shard " << shard << " draining, new connections are refused\n" << std::flush;
+            break;
+
+        case ADMIN_OP::Status:
+            break; // Thread principal
+    }
+}
+
+#pragma endregion
+
+#pragma region Shards
+
+// Le signal peut arriver sur n'importe quel thread : atomique sans verrou, seul type sûr dans un gestionnaire
+std::atomic<bool> restartRequested = false;
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+// Rechargée par le thread principal, chaque shard en reprend une copie quand la version change
+struct SharedConfig
+{
+    std::mutex mutex;
+    ServerConfig config;
+    std::atomic<std::uint32_t> version = 0;
+};
+
+// Un ENetHost et sa salle. Le thread réseau est le seul à toucher l'host et ses peers,
+// le thread de simulation possède gameData : ils ne communiquent que par link
+struct Shard
+{
+    ENetHost* host = nullptr;
+    GameData gameData;
+    NetLink link;
+    WorldViewBuffer worldView; // Écrite par le thread de simulation, lue par le thread principal
+    AdminQueue admin; // Remplie par le thread de contrôle, vidée par le thread de simulation entre deux ticks
+    std::thread networkThread;
+    std::thread simulationThread;
+};
+
+// Copie locale de la config partagée, reprise quand la version change. Retourne true si config a changé
+bool sync_config(SharedConfig& a_sharedConfig, ServerConfig& a_config, std::uint32_t& a_version)
+{
+    if (a_sharedConfig.version.load(std::memory_order_acquire) == a_version)
+        return false;
+
+    std::lock_guard lock(a_sharedConfig.mutex);
+    a_config = a_sharedConfig.config;
+    a_version = a_sharedConfig.version.load(std::memory_order_relaxed);
+    return true;
+}
+
+// a_socket : socket déjà lié (hérité d'un redémarrage à chaud ou partagé entre shards), -1 -> ENet crée le sien sur a_port
+ENetHost* create_host(const ServerConfig& a_config, enet_uint16 a_port, std::int64_t a_socket)
+{
+    ENetAddress address;
+    enet_address_build_any(&address, ENET_ADDRESS_TYPE_IPV6);
+
+#ifndef _WIN32
+    if (a_socket >= 0 && fcntl(static_cast<int>(a_socket), F_GETFD) >= 0)
+    {
+        // ENet ne sait pas adopter un socket : on crée l'host sur un port libre puis on remplace le sien
+        address.port = 0;
+
+        ENetHost* host = enet_host_create(ENET_ADDRESS_TYPE_ANY, &address, a_config.maxPeers, a_config.channelCount, a_config.incomingBandwidth, a_config.outgoingBandwidth);
+        if (host)
+        {
+            enet_socket_destroy(host->socket);
+            host->socket = static_cast<ENetSocket>(a_socket);
+            return host;
+        }
+    }
+    else if (a_socket >= 0)
+    {
+        std::cerr << "ERROR -> create_host : Socket " << a_socket << " is not open, binding a new one\n" << std::flush;
+    }
+#endif
+
+    address.port = a_port;
+    return enet_host_create(ENET_ADDRESS_TYPE_ANY, &address, a_config.maxPeers, a_config.channelCount, a_config.incomingBandwidth, a_config.outgoingBandwidth);
+}
+
+void run_shard_network(Shard& a_shard, SharedConfig& a_sharedConfig, const std::atomic<bool>& a_running)
+{
+    ENetHost* host = a_shard.host;
+    NetLink& link = a_shard.link;
+
+    ServerConfig config;
+    std::uint32_t configVersion = ~0u;
+    sync_config(a_sharedConfig, config, configVersion);
+
+    std::chrono::time_point lastStatsLog = n_clock::now();
+    std::uint64_t serviceCalls = 0; // Réveils de enet_host_service depuis le dernier log
+
+    while (a_running.load(std::memory_order_relaxed))
+    {
+        std::chrono::time_point now = n_clock::now();
+
+        if (sync_config(a_sharedConfig, config, configVersion))
+            enet_host_bandwidth_limit(host, config.incomingBandwidth, config.outgoingBandwidth);
+
+        if (config.statsLogInterval > 0 && now - lastStatsLog >= std::chrono::seconds(config.statsLogInterval))
+        {
+            std::cout << "Shard " << static_cast<int>(a_shard.gameData.shard) << " : " << serviceCalls << " service calls\n" << std::flush;
+            lastStatsLog = now;
+            serviceCalls = 0;
+        }
+
+        // Échéance lue avant de vider la sortie : si elle est à venir, tout ce que le tick précédent a produit est déjà dans la file
+        n_clock::time_point deadline{ n_clock::duration(link.nextDeadline.load(std::memory_order_acquire)) };
+
+        // Tout ce que la simulation a produit part d'un coup
+        if (link.DeliverOutputs())
+            enet_host_flush(host);
+
+        link.FlushPendingCommands();
+
+        // Dort jusqu'au prochain tick ou au premier datagramme. Tick en cours : on revient vite chercher sa sortie
+        enet_uint32 serviceTimeout = ShardOutputPollDelay;
+        if (deadline > now)
+            serviceTimeout = static_cast<enet_uint32>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count());
+        ++serviceCalls;
+
+        ENetEvent event;
+        if (enet_host_service(host, &event, serviceTimeout) > 0)
+        {
+            do
+            {
+                link.HandleEvent(event);
+            } while (enet_host_check_events(host, &event) > 0);
+        }
+    }
+}
+
+void run_shard_simulation(Shard& a_shard, SharedConfig& a_sharedConfig, const std::atomic<bool>& a_running)
+{
+    GameData& gameData = a_shard.gameData;
+    NetLink& link = a_shard.link;
+
+    // Les envois de ce thread passent par le thread réseau
+    bind_thread_netlink(&link);
+
+    ServerConfig config;
+    std::uint32_t configVersion = ~0u;
+    sync_config(a_sharedConfig, config, configVersion);
+
+    //Init clock
+    std::chrono::time_point lastTickLogic = n_clock::now();
+    std::chrono::time_point lastTickNetwork = n_clock::now();
+    std::chrono::time_point lastStatsLog = n_clock::now();
+
+    std::chrono::milliseconds LogicTickRate = std::chrono::milliseconds(config.LogicTickDelay());
+    std::chrono::milliseconds NetworkTickRate = std::chrono::milliseconds(config.NetworkTickDelay());
+
+    SnapshotEncoder encoder;
+    encoder.pool.Start(config.encodeWorkers);
+
+    while (a_running.load(std::memory_order_relaxed))
+    {
+        if (sync_config(a_sharedConfig, config, configVersion))
+        {
+            LogicTickRate = std::chrono::milliseconds(config.LogicTickDelay());
+            NetworkTickRate = std::chrono::milliseconds(config.NetworkTickDelay());
+        }
+
+        link.FlushPendingOutputs();
+
+        // Publiée après les envois du tick précédent : le thread réseau les livre puis dort jusque-là
+        std::chrono::time_point nextTick = std::min(lastTickLogic + LogicTickRate, lastTickNetwork + NetworkTickRate);
+        link.nextDeadline.store(nextTick.time_since_epoch().count(), std::memory_order_release);
+
+        std::this_thread::sleep_until(nextTick);
+        std::chrono::time_point now = n_clock::now();
+
+        // Tout ce qui est arrivé pendant le tick précédent, appliqué avant de simuler
+        NetCommand command;
+        while (link.PopCommand(command))
+            apply_command(gameData, command, config);
+
+        AdminCommand adminCommand;
+        while (a_shard.admin.TryPop(adminCommand))
+            apply_admin_command(gameData, adminCommand);
+
+        if (config.statsLogInterval > 0 && now - lastStatsLog >= std::chrono::seconds(config.statsLogInterval))
+        {
+            std::cout << "Shard " << static_cast<int>(gameData.shard) << " events : " << gameData.events.EmittedCount() << " emitted, " << gameData.events.CoalescedCount() << " coalesced\n" << std::flush;
+            std::cout << "Shard " << static_cast<int>(gameData.shard) << " match arena : " << gameData.matchArena.ReservedBytes() << " bytes reserved, " << gameData.matchArena.ResetCount() << " resets\n" << std::flush;
+
+            if (encoder.encodeCount > 0)
+            {
+                std::cout << "Shard " << static_cast<int>(gameData.shard) << " encoding : " << encoder.encodeNanoseconds / encoder.encodeCount / 1000 << " us per network tick, "
+                    << encoder.pool.WorkerCount() << " workers\n" << std::flush;
+                encoder.encodeNanoseconds = 0;
+                encoder.encodeCount = 0;
+            }
+
+            lastStatsLog = now;
+        }
+
+        auto deltaLogic = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTickLogic);
+        if (deltaLogic >= LogicTickRate)
+        {
+            // Virgule fixe : pas nominal, le résultat ne doit pas dépendre du moment où le thread s'est réveillé
+            float deltaTime = config.physics.fixedPoint ? 1.0f / config.logicTickRate : std::chrono::duration<float>(deltaLogic).count();
+            update_matchmaking(gameData, config);
+            tick_logic(gameData, config.physics, deltaTime);
+            publish_world_view(a_shard.worldView, gameData);
+
+            lastTickLogic = now;
+        }
+
+        auto deltaNetwork = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTickNetwork);
+        if (deltaNetwork >= NetworkTickRate)
+        {
+            tick_network(gameData, encoder, config, std::chrono::duration<float>(deltaNetwork).count());
+
+            lastTickNetwork = now;
+        }
+    }
+
+    bind_thread_netlink(nullptr);
+}
+
+// Shard arrêté : le thread appelant termine ce que ses threads ont laissé dans les files
+void drain_shard(Shard& a_shard, const ServerConfig& a_config)
+{
+    bind_thread_netlink(&a_shard.link);
+
+    // Les deux threads sont arrêtés : celui-ci joue les deux rôles, commandes mises de côté comprises
+    NetCommand command;
+    bool flushed;
+    do
+    {
+        flushed = a_shard.link.FlushPendingCommands();
+        while (a_shard.link.PopCommand(command))
+            apply_command(a_shard.gameData, command, a_config);
+    } while (!flushed);
+
+    bind_thread_netlink(nullptr);
+
+    bool sent = false;
+    do
+    {
+        flushed = a_shard.link.FlushPendingOutputs();
+        sent |= a_shard.link.DeliverOutputs();
+    } while (!flushed);
+
+    if (sent)
+        enet_host_flush(a_shard.host);
+}
+
+void start_shards(std::vector<Shard>& a_shards, SharedConfig& a_sharedConfig, const std::atomic<bool>& a_running)
+{
+    for (Shard& shard : a_shards)
+    {
+        shard.networkThread = std::thread(run_shard_network, std::ref(shard), std::ref(a_sharedConfig), std::cref(a_running));
+        shard.simulationThread = std::thread(run_shard_simulation, std::ref(shard), std::ref(a_sharedConfig), std::cref(a_running));
+    }
+}
+
+void stop_shards(std::vector<Shard>& a_shards, std::atomic<bool>& a_running)
+{
+    a_running.store(false, std::memory_order_relaxed);
+    for (Shard& shard : a_shards)
+    {
+        if (shard.simulationThread.joinable())
+            shard.simulationThread.join();
+        if (shard.networkThread.joinable())
+            shard.networkThread.join();
+    }
+    a_running.store(true, std::memory_order_relaxed);
+}
+
+// Thread principal, depuis la vue publiée : les salles continuent de tourner pendant la lecture
+void print_room_status(std::vector<Shard>& a_shards)
+{
+    for (std::size_t i = 0; i < a_shards.size(); ++i)
+    {
+        const WorldView& view = a_shards[i].worldView.Read();
+        std::size_t connected = std::count_if(view.players.begin(), view.players.end(), [](const WorldViewPlayer& player) { return player.connected; });
+        std::cout << "Shard " << i << " room : tick " << view.tick << ", " << view.players.size() << " players (" << connected << " connected)\n" << std::flush;
+    }
+}
+
+bool has_connected_players(std::vector<Shard>& a_shards)
+{
+    return std::any_of(a_shards.begin(), a_shards.end(), [](Shard& shard)
+        {
+            const WorldView& view = shard.worldView.Read();
+            return std::any_of(view.players.begin(), view.players.end(), [](const WorldViewPlayer& player) { return player.connected; });
+        });
+}
+
+#pragma endregion
+
+#pragma region HotRestart
+
+// Shards arrêtés. Coupe les clients (ils se reconnectent avec leur token), écrit un checkpoint par shard puis remplace le processus par le binaire déployé.
+// Ne revient qu'en cas d'échec : les places restent alors réservées dans ce processus
+void hot_restart(std::vector<Shard>& a_shards, const ServerConfig& a_config, enet_uint16 a_port, char** argv)
+{
+#ifdef _WIN32
+    (void)a_shards; (void)a_config; (void)a_port; (void)argv;
+    std::cerr << "ERROR -> hot_restart : Not supported on Windows\n" << std::flush;
+#else
+    // Les sockets doivent survivre à exec
+    for (Shard& shard : a_shards)
+    {
+        int flags = fcntl(shard.host->socket, F_GETFD);
+        if (flags < 0 || fcntl(shard.host->socket, F_SETFD, flags & ~FD_CLOEXEC) != 0)
+        {
+            std::cerr << "ERROR -> hot_restart : Cannot hand the sockets over, restart aborted\n" << std::flush;
+            return;
+        }
+    }
+
+    for (Shard& shard : a_shards)
+    {
+        std::cout << "Hot restart requested, checkpointing shard " << static_cast<int>(shard.gameData.shard) << " (" << shard.gameData.players.size() << " players)...\n" << std::flush;
+
+        drain_shard(shard, a_config);
+
+        for (PlayerData& player : shard.gameData.players)
+        {
+            if (player.peer == nullptr)
+                continue;
+
+            disconnect_peer(player, static_cast<enet_uint32>(DISCONNECT_REASON::Restart));
+            detach_player(player, shard.gameData, a_config);
+        }
+
+        Checkpoint checkpoint;
+        checkpoint.state = shard.gameData.state;
+        checkpoint.tick = shard.gameData.tick;
+        checkpoint.serverTime = get_server_time();
+        checkpoint.socket = shard.host->socket;
+        checkpoint.port = a_port;
+        checkpoint.shard = shard.gameData.shard;
+        checkpoint.shardCount = shard.gameData.shardCount;
+
+        if (!SaveCheckpoint(GetShardCheckpointPath(a_config.checkpointFile, shard.gameData.shard), checkpoint, shard.gameData.players))
+        {
+            std::cerr << "ERROR -> hot_restart : Checkpoint failed, restart aborted\n" << std::flush;
+            return;
+        }
+    }
+
+    std::string resumeFlag = "--resume";
+    std::string checkpointFile = a_config.checkpointFile;
+
+    // Passés hors checkpoint : le nouveau processus les adopte même s'il ne peut pas relire un checkpoint
+    std::string socketsFlag = "--sockets";
+    std::string sockets = std::to_string(a_port) + ":";
+    for (std::size_t i = 0; i < a_shards.size(); ++i)
+        sockets += (i > 0 ? "," : "") + std::to_string(a_shards[i].host->socket);
+
+    std::vector<char*> arguments;
+    for (int i = 0; argv[i] != nullptr; ++i)
+    {
+        if ((resumeFlag == argv[i] || socketsFlag == argv[i]) && argv[i + 1] != nullptr)
+        {
+            ++i; // Remplacé par le nouveau checkpoint et les sockets actuels
+            continue;
+        }
+
+        arguments.push_back(argv[i]);
+    }
+    arguments.push_back(resumeFlag.data());
+    arguments.push_back(checkpointFile.data());
+    arguments.push_back(socketsFlag.data());
+    arguments.push_back(sockets.data());
+    arguments.push_back(nullptr);
+
+    // Par le chemin et pas /proc/self/exe, qui désigne encore l'ancien binaire s'il a été remplacé
+    execvp(argv[0], arguments.data());
+
+    std::cerr << "ERROR -> hot_restart : Cannot exec " << argv[0] << ", resuming in this process\n" << std::flush;
+#endif
+}
+
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+    ConfigSource configSource;
+    if (!ParseCommandLine(argc, argv, configSource))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ServerConfig config;
+    if (!LoadConfig(configSource, config))
+    {
+        std::cerr << "Failed to load config\n" << std::flush;
+        return EXIT_FAILURE;
+    }
+
+    std::size_t shardCount = config.listenerShards;
+#if defined(_WIN32) || !defined(SO_REUSEPORT)
+    shardCount = 1;
+#endif
+
+    // Un shard par socket hérité : chacun est adopté, même si son checkpoint est illisible, pour qu'aucun ne fuie
+    if (!configSource.inheritedSockets.empty())
+        shardCount = configSource.inheritedSockets.size();
+
+    std::vector<Checkpoint> checkpoints;
+    std::vector<std::vector<PlayerData>> restoredPlayers;
+    std::vector<bool> resumed;
+
+    // Un checkpoint par shard : le nombre de shards du processus précédent est conservé, sinon des salles seraient perdues
+    if (!configSource.resumePath.empty())
+    {
+        Checkpoint checkpoint;
+        std::vector<PlayerData> players;
+        if (!LoadCheckpoint(GetShardCheckpointPath(configSource.resumePath, 0), checkpoint, players))
+            std::cerr << "Failed to resume from " << configSource.resumePath << ", starting empty rooms\n" << std::flush;
+        else if (configSource.inheritedSockets.empty())
+            shardCount = std::max<std::size_t>(checkpoint.shardCount, 1);
+
+        checkpoints.resize(shardCount);
+        restoredPlayers.resize(shardCount);
+        resumed.resize(shardCount, false);
+
+        for (std::size_t i = 0; i < shardCount; ++i)
+        {
+            std::string path = GetShardCheckpointPath(configSource.resumePath, i);
+            resumed[i] = LoadCheckpoint(path, checkpoints[i], restoredPlayers[i]);
+
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+    else
+    {
+        checkpoints.resize(shardCount);
+        restoredPlayers.resize(shardCount);
+        resumed.resize(shardCount, false);
+    }
+
+    // Sockets hérités : déjà liés à ce port, quel que soit le résultat du chargement des checkpoints
+    enet_uint16 port = config.port;
+    if (!configSource.inheritedSockets.empty() && configSource.inheritedPort != 0)
+        port = configSource.inheritedPort;
+    else if (resumed[0] && checkpoints[0].port != 0)
+        port = checkpoints[0].port;
+
+    if (port == 0)
+    {
+        port = (enet_uint16)std::experimental::randint(minPort, maxPort);
+        std::cout << "No port given, random port assigned...\n" << std::flush;
+    }
+
+    if (!initialize_enet_with_pools())
+    {
+        std::cout << "Failed to initialize ENet\n" << std::flush;
+        return EXIT_FAILURE;
+    }
+
+    Arena arena;
+    if (!LoadArena(config.mapFile, arena))
+    {
+        std::cerr << "Failed to load map " << config.mapFile << "\n" << std::flush;
+        return EXIT_FAILURE;
+    }
+
+    //création hôtes server, un par shard
+    std::vector<Shard> shards(shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        std::int64_t socket = -1;
+        if (i < configSource.inheritedSockets.size())
+            socket = configSource.inheritedSockets[i];
+        else if (resumed[i])
+            socket = checkpoints[i].socket;
+        else if (shardCount > 1)
+            socket = create_shard_socket(port);
+
+        shards[i].host = create_host(config, port, socket);
+        if (!shards[i].host)
+        {
+            std::cerr << "Failed to create ENet host\n" << std::flush;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Un client qui revient (reprise, redémarrage à chaud) retombe sur le shard de sa salle. Sans filtre, Retry reste le recours
+    if (shardCount > 1 && !attach_shard_selector(shards[0].host->socket, shardCount))
+        std::cerr << "Shard selection by address unavailable, returning clients may need several retries\n" << std::flush;
+
+    get_server_time(); // Démarre l'horloge serveur
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        if (resumed[i])
+        {
+            resume_server_time(checkpoints[i].serverTime);
+            break;
+        }
+    }
+
+    std::cout << "Server creation success!\n" << std::flush;
+    std::cout << "Port : " << port << " (" << shardCount << " shards)\n" << std::flush;
+
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        GameData& gameData = shards[i].gameData;
+        gameData.arena = &arena;
+        gameData.shard = static_cast<std::uint8_t>(i);
+        gameData.shardCount = static_cast<std::uint8_t>(shardCount);
+
+        if (resumed[i])
+        {
+            // Joueurs à leur place, peers à nullptr : les clients reprennent leur session avec leur token
+            gameData.state = checkpoints[i].state;
+            gameData.tick = checkpoints[i].tick;
+            gameData.players = std::move(restoredPlayers[i]);
+
+            for (PlayerData& player : gameData.players)
+            {
+                player.sendBudget = 0;
+                player.inputAcks.Reset();
+                player.capabilities = 0;
+                player.lastSnapshotHash = 0;
+                player.unchangedSnapshots = 0;
+
+                // Partie en cours : sa liste n'est pas dans le checkpoint, elle se déduit de l'état des joueurs
+                if (gameData.state == GAME_STATE::game && is_match_player(player))
+                    gameData.matchPlayers.push_back(player.id);
+            }
+
+            std::cout << "Shard " << i << " resumed " << gameData.players.size() << " players at tick " << gameData.tick << "\n" << std::flush;
+        }
+
+        bool hasBots = std::any_of(gameData.players.begin(), gameData.players.end(), [](const PlayerData& player) { return player.isBot; });
+        if (config.botCount > 0 || hasBots)
+        {
+            gameData.bots.grid.Build(arena, config.physics);
+            gameData.bots.initialized = true;
+
+            if (!resumed[i])
+            {
+                AddBots(gameData.players, config.botCount, gameData.bots.grid);
+                std::cout << config.botCount << " bots added to shard " << i << "\n" << std::flush;
+            }
+        }
+    }
+
+#ifndef _WIN32
+    std::signal(SIGUSR2, [](int) { restartRequested.store(true, std::memory_order_relaxed); });
+#endif
+
+    SharedConfig sharedConfig;
+    sharedConfig.config = config;
+
+    std::atomic<bool> running = true;
+
+    std::cout << "Starting Server loop...\n" << std::flush;
+    start_shards(shards, sharedConfig, running);
+
+    ControlServer control;
+    if (!config.controlSocket.empty())
+    {
+        std::vector<AdminQueue*> adminQueues;
+        for (Shard& shard : shards)
+            adminQueues.push_back(&shard.admin);
+
+        if (control.Start(config.controlSocket, std::move(adminQueues)))
+            std::cout << "Control socket : " << config.controlSocket << "\n" << std::flush;
+    }
+    bool draining = false;
+
+    // Le thread principal ne touche plus aux hosts : config, stats et redémarrage
+    std::chrono::time_point lastConfigCheck = n_clock::now();
+    std::chrono::time_point lastStatsLog = n_clock::now();
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ShardSupervisorDelay));
+
+        std::chrono::time_point now = n_clock::now();
+
+        if (restartRequested.exchange(false, std::memory_order_relaxed))
+        {
+
+            stop_shards(shards, running);
+            hot_restart(shards, config, port, argv);
+            start_shards(shards, sharedConfig, running);
+        }
+
+        AdminCommand adminCommand;
+        while (control.PopCommand(adminCommand))
+        {
+            if (adminCommand.op == ADMIN_OP::Status)
+                print_room_status(shards);
+            else if (adminCommand.op == ADMIN_OP::Drain && !draining)
+            {
+                draining = true;
+                std::cout << "Draining : the server stops when no player is connected\n" << std::flush;
+            }
+        }
+
+        if (draining && !has_connected_players(shards))
+        {
+            control.Stop();
+            stop_shards(shards, running);
+
+            // Arrivés entre la dernière vue publiée et l'arrêt des shards
+            for (Shard& shard : shards)
+            {
+                drain_shard(shard, config);
+                for (PlayerData& player : shard.gameData.players)
+                    disconnect_peer(player, static_cast<enet_uint32>(DISCONNECT_REASON::Draining));
+            }
+
+            std::cout << "Drained, server stopped\n" << std::flush;
+            return EXIT_SUCCESS;
+        }
+
+        if (now - lastConfigCheck >= std::chrono::milliseconds(ConfigReloadCheckDelay))
+        {
+            if (ReloadConfigIfChanged(configSource, config))
+            {
+                std::lock_guard lock(sharedConfig.mutex);
+                sharedConfig.config = config;
+                sharedConfig.version.fetch_add(1, std::memory_order_release);
+            }
+
+            lastConfigCheck = now;
+        }
+
+        if (config.statsLogInterval > 0 && now - lastStatsLog >= std::chrono::seconds(config.statsLogInterval))
+        {
+            print_room_status(shards);
+
+            PrintAllocatorStats(std::cout);
+            PrintCompressionStats(std::cout);
+            lastStatsLog = now;
+        }
+    }
+}
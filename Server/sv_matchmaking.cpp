@@ -0,0 +1,264 @@
+#include "sv_matchmaking.hpp"
+
+#include <algorithm>
+
+void Matchmaker::Enqueue(idSize_t a_player, std::uint32_t a_party, std::uint32_t a_roundTripTime, std::uint32_t a_now, std::uint32_t a_bucketWidth)
+{
+    Remove(a_player);
+
+    std::uint32_t id = 0;
+    if (a_party != 0)
+    {
+        auto party = m_parties.find(a_party);
+        if (party != m_parties.end() && m_tickets.at(party->second).members.size() < MaxPartySize)
+            id = party->second;
+    }
+
+    if (id == 0)
+    {
+        // Groupe complet : les membres suivants forment un nouveau ticket, qui accueille désormais le groupe
+        id = m_nextTicket++;
+        Ticket& ticket = m_tickets[id];
+        ticket.party = a_party;
+        ticket.enqueueTime = a_now;
+        if (a_party != 0)
+            m_parties[a_party] = id;
+    }
+    else
+    {
+        Unindex(id, m_tickets.at(id));
+    }
+
+    Ticket& ticket = m_tickets.at(id);
+    ticket.members.push_back({ a_player, a_roundTripTime });
+    ticket.bucket = Bucket(ticket, a_bucketWidth);
+    Index(id, ticket);
+
+    m_playerTicket[a_player] = id;
+}
+
+void Matchmaker::Remove(idSize_t a_player)
+{
+    std::uint32_t id = m_playerTicket[a_player];
+    if (id == 0)
+        return;
+
+    m_playerTicket[a_player] = 0;
+
+    auto it = m_tickets.find(id);
+    Ticket& ticket = it->second;
+    Unindex(id, ticket);
+
+    std::erase_if(ticket.members, [&](const Member& member) { return member.id == a_player; });
+    if (!ticket.members.empty())
+    {
+        // Tranche gardée jusqu'à la prochaine mesure de RTT
+        Index(id, ticket);
+        return;
+    }
+
+    auto party = m_parties.find(ticket.party);
+    if (party != m_parties.end() && party->second == id)
+        m_parties.erase(party);
+
+    m_tickets.erase(it);
+}
+
+void Matchmaker::UpdateLatency(idSize_t a_player, std::uint32_t a_roundTripTime, std::uint32_t a_bucketWidth)
+{
+    std::uint32_t id = m_playerTicket[a_player];
+    if (id == 0)
+        return;
+
+    Ticket& ticket = m_tickets.at(id);
+    for (Member& member : ticket.members)
+    {
+        if (member.id == a_player)
+            member.roundTripTime = a_roundTripTime;
+    }
+
+    std::uint8_t bucket = Bucket(ticket, a_bucketWidth);
+    if (bucket == ticket.bucket)
+        return;
+
+    Unindex(id, ticket);
+    ticket.bucket = bucket;
+    Index(id, ticket);
+}
+
+bool Matchmaker::FormMatch(std::pmr::vector<idSize_t>& a_match, std::size_t a_matchSize, std::uint32_t a_now, std::uint32_t a_maxWait)
+{
+    a_match.clear();
+    if (a_matchSize == 0 || m_queuedPlayers < a_matchSize)
+        return false;
+
+    thread_local std::vector<std::uint32_t> taken;
+    taken.clear();
+
+    SizeCounts chosen{};
+
+    // Tranche la plus rapide d'abord : les joueurs proches du serveur jouent ensemble
+    for (std::uint8_t bucket = 0; bucket < MatchRttBuckets && taken.empty(); ++bucket)
+    {
+        if (m_bucketPlayers[bucket] < a_matchSize || !ChooseSizes(m_bucketTickets[bucket], a_matchSize, chosen))
+            continue;
+
+        for (std::size_t size = 1; size <= MaxPartySize; ++size)
+        {
+            for (std::size_t i = 0; i < chosen[size]; ++i)
+                taken.push_back(TakeOldest(bucket, size));
+        }
+    }
+
+    if (taken.empty() && a_maxWait > 0)
+    {
+        // Le plus ancien attend depuis trop longtemps : il part avec les tranches voisines de la sienne,
+        // élargies une à une jusqu'à ce qu'une combinaison existe
+        auto oldest = m_tickets.begin();
+        std::size_t oldestSize = oldest->second.members.size();
+        if (a_now - oldest->second.enqueueTime >= a_maxWait && oldestSize <= a_matchSize)
+        {
+            int origin = oldest->second.bucket;
+            Unindex(oldest->first, oldest->second);
+
+            // Tranches à a_distance de celle du plus ancien, une seule à distance 0
+            auto visit = [&](int a_distance, auto&& a_function)
+            {
+                if (origin - a_distance >= 0)
+                    a_function(static_cast<std::uint8_t>(origin - a_distance));
+                if (a_distance > 0 && origin + a_distance < static_cast<int>(MatchRttBuckets))
+                    a_function(static_cast<std::uint8_t>(origin + a_distance));
+            };
+
+            SizeCounts available{};
+            for (int distance = 0; distance < static_cast<int>(MatchRttBuckets); ++distance)
+            {
+                visit(distance, [&](std::uint8_t a_bucket)
+                {
+                    for (std::size_t size = 1; size <= MaxPartySize; ++size)
+                        available[size] += m_bucketTickets[a_bucket][size];
+                });
+
+                if (!ChooseSizes(available, a_matchSize - oldestSize, chosen))
+                    continue;
+
+                // Tranches les plus proches d'abord, pour chaque taille
+                taken.push_back(oldest->first);
+                for (int reach = 0; reach <= distance; ++reach)
+                {
+                    visit(reach, [&](std::uint8_t a_bucket)
+                    {
+                        for (std::size_t size = 1; size <= MaxPartySize; ++size)
+                        {
+                            std::uint32_t id;
+                            while (chosen[size] > 0 && (id = TakeOldest(a_bucket, size)) != 0)
+                            {
+                                taken.push_back(id);
+                                --chosen[size];
+                            }
+                        }
+                    });
+                }
+                break;
+            }
+
+            if (taken.empty())
+                Index(oldest->first, oldest->second);
+        }
+    }
+
+    if (taken.empty())
+        return false;
+
+    // Tickets déjà retirés de l'index : il ne reste qu'à les supprimer
+    for (std::uint32_t id : taken)
+    {
+        auto it = m_tickets.find(id);
+        for (const Member& member : it->second.members)
+        {
+            a_match.push_back(member.id);
+            m_playerTicket[member.id] = 0;
+        }
+
+        auto party = m_parties.find(it->second.party);
+        if (party != m_parties.end() && party->second == id)
+            m_parties.erase(party);
+
+        m_tickets.erase(it);
+    }
+
+    return true;
+}
+
+std::uint8_t Matchmaker::Bucket(const Ticket& a_ticket, std::uint32_t a_bucketWidth)
+{
+    if (a_bucketWidth == 0)
+        return 0;
+
+    std::uint32_t worst = 0;
+    for (const Member& member : a_ticket.members)
+        worst = std::max(worst, member.roundTripTime);
+
+    return static_cast<std::uint8_t>(std::min<std::uint32_t>(worst / a_bucketWidth, MatchRttBuckets - 1));
+}
+
+void Matchmaker::Index(std::uint32_t a_id, const Ticket& a_ticket)
+{
+    m_index.emplace(a_ticket.bucket, static_cast<std::uint8_t>(a_ticket.members.size()), a_id);
+    m_bucketPlayers[a_ticket.bucket] += a_ticket.members.size();
+    ++m_bucketTickets[a_ticket.bucket][a_ticket.members.size()];
+    m_queuedPlayers += a_ticket.members.size();
+}
+
+void Matchmaker::Unindex(std::uint32_t a_id, const Ticket& a_ticket)
+{
+    m_index.erase({ a_ticket.bucket, static_cast<std::uint8_t>(a_ticket.members.size()), a_id });
+    m_bucketPlayers[a_ticket.bucket] -= a_ticket.members.size();
+    --m_bucketTickets[a_ticket.bucket][a_ticket.members.size()];
+    m_queuedPlayers -= a_ticket.members.size();
+}
+
+bool Matchmaker::ChooseSizes(const SizeCounts& a_available, std::size_t a_players, SizeCounts& a_chosen)
+{
+    // Retour arrière sur les tailles : 3 + 2 + 2 ne fait pas 4 par le plus grand d'abord, mais 2 + 2 oui.
+    // Au plus a_players / size essais par taille, MaxPartySize niveaux
+    auto choose = [&](auto& a_self, std::size_t a_size, std::size_t a_remaining) -> bool
+    {
+        if (a_size == 1)
+        {
+            a_chosen[1] = a_remaining;
+            return a_remaining <= a_available[1];
+        }
+
+        std::size_t smaller = 0;
+        for (std::size_t size = 1; size < a_size; ++size)
+            smaller += size * a_available[size];
+
+        for (std::size_t count = std::min(a_available[a_size], a_remaining / a_size) + 1; count-- > 0;)
+        {
+            std::size_t left = a_remaining - count * a_size;
+            if (left > smaller)
+                return false; // Moins de grands groupes ne laisserait que plus de joueurs à placer
+
+            a_chosen[a_size] = count;
+            if (a_self(a_self, a_size - 1, left))
+                return true;
+        }
+
+        return false;
+    };
+
+    a_chosen = {};
+    return choose(choose, MaxPartySize, a_players);
+}
+
+std::uint32_t Matchmaker::TakeOldest(std::uint8_t a_bucket, std::size_t a_size)
+{
+    auto it = m_index.lower_bound({ a_bucket, static_cast<std::uint8_t>(a_size), 0 });
+    if (it == m_index.end() || std::get<0>(*it) != a_bucket || std::get<1>(*it) != a_size)
+        return 0;
+
+    std::uint32_t id = std::get<2>(*it);
+    Unindex(id, m_tickets.at(id));
+    return id;
+}
@@ -0,0 +1,80 @@
+#ifndef _SV_MATCHMAKING_HPP
+#define _SV_MATCHMAKING_HPP 1
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "sv_constant.hpp"
+
+// File d'attente d'une salle. Un ticket = un joueur seul ou les membres d'un même groupe présents dans la salle,
+// rangé dans une tranche de latence selon le RTT le plus élevé de ses membres.
+// Une partie se forme dans une seule tranche, groupes entiers. Le nombre de tickets de chaque taille est choisi d'abord
+// (recherche bornée par MaxPartySize), puis chaque ticket pris coûte O(log n)
+class Matchmaker
+{
+public:
+    // a_party != 0 : rejoint le ticket de son groupe s'il attend encore et a de la place
+    void Enqueue(idSize_t a_player, std::uint32_t a_party, std::uint32_t a_roundTripTime, std::uint32_t a_now, std::uint32_t a_bucketWidth);
+    void Remove(idSize_t a_player);
+
+    // RTT mesuré à nouveau : le ticket ne change de tranche que si son pire RTT en change
+    void UpdateLatency(idSize_t a_player, std::uint32_t a_roundTripTime, std::uint32_t a_bucketWidth);
+
+    // Remplit a_match avec exactement a_matchSize joueurs, depuis la tranche la plus rapide qui le permet.
+    // Quand le plus ancien ticket attend depuis a_maxWait ms (0 -> jamais), les tranches voisines de la sienne sont ajoutées
+    bool FormMatch(std::pmr::vector<idSize_t>& a_match, std::size_t a_matchSize, std::uint32_t a_now, std::uint32_t a_maxWait);
+
+    bool IsQueued(idSize_t a_player) const { return m_playerTicket[a_player] != 0; }
+    std::size_t QueuedPlayers() const { return m_queuedPlayers; }
+
+private:
+    struct Member
+    {
+        idSize_t id;
+        std::uint32_t roundTripTime; // ms
+    };
+
+    struct Ticket
+    {
+        std::uint32_t party = 0;
+        std::uint32_t enqueueTime = 0; // ms, heure serveur
+        std::uint8_t bucket = 0;
+        std::vector<Member> members;
+    };
+
+    // Tranche, taille, ticket : les tickets d'une tranche et d'une taille donnée, du plus ancien au plus récent
+    using TicketKey = std::tuple<std::uint8_t, std::uint8_t, std::uint32_t>;
+
+    // Nombre de tickets par taille de groupe (indice 0 inutilisé)
+    using SizeCounts = std::array<std::size_t, MaxPartySize + 1>;
+
+    static std::uint8_t Bucket(const Ticket& a_ticket, std::uint32_t a_bucketWidth);
+    void Index(std::uint32_t a_id, const Ticket& a_ticket);
+    void Unindex(std::uint32_t a_id, const Ticket& a_ticket);
+
+    // Tickets de chaque taille, pris dans a_available, qui font exactement a_players joueurs.
+    // Plus grands groupes d'abord, les joueurs seuls complètent. false si aucune combinaison
+    static bool ChooseSizes(const SizeCounts& a_available, std::size_t a_players, SizeCounts& a_chosen);
+
+    // Plus ancien ticket de a_bucket avec exactement a_size joueurs, retiré de l'index. 0 si aucun
+    std::uint32_t TakeOldest(std::uint8_t a_bucket, std::size_t a_size);
+
+    std::map<std::uint32_t, Ticket> m_tickets; // Identifiants croissants : le premier est le plus ancien
+    std::set<TicketKey> m_index;
+    std::unordered_map<std::uint32_t, std::uint32_t> m_parties; // Groupe -> ticket qui l'accueille
+    std::array<std::uint32_t, static_cast<std::size_t>(std::numeric_limits<idSize_t>::max()) + 1> m_playerTicket{}; // 0 -> pas dans la file
+    std::array<std::size_t, MatchRttBuckets> m_bucketPlayers{};
+    std::array<SizeCounts, MatchRttBuckets> m_bucketTickets{};
+    std::size_t m_queuedPlayers = 0;
+    std::uint32_t m_nextTicket = 1;
+};
+
+#endif //_SV_MATCHMAKING_HPP
@@ -24,13 +24,6 @@ Vector3f::Vector3f(const float X, const float Y, const float Z)
     z = Z;
 }
 
-Vector3f::Vector3f(const Vector3f &vector)
-{
-    x = vector.x;
-    y = vector.y;
-    z = vector.z;
-}
-
 Vector3f Vector3f::operator+(const Vector3f &vector) const
 {
     return Vector3f(x + vector.x, y + vector.y, z + vector.z);
@@ -51,11 +44,6 @@ Vector3f Vector3f::operator/(const float &value) const
     return Vector3f(x / value, y / value, z / value);
 }
 
-Vector3f Vector3f::operator=(const Vector3f &vector)
-{
-    return Vector3f(vector);
-}
-
 Vector3f Vector3f::operator+=(const Vector3f &vector)
 {
     x += vector.x;
@@ -94,7 +82,12 @@ Vector3f Vector3f::operator/=(const float &value)
 
 Vector3f Vector3f::normalized() const
 {
-    float ratio = 1 / magnitude();
+    // Vecteur nul : pas de direction, on évite de propager NaN
+    float length = magnitude();
+    if (length == 0.0f)
+        return Zero();
+
+    float ratio = 1 / length;
 
     return Vector3f(x * ratio, y * ratio, z * ratio);
 }
@@ -110,6 +103,11 @@ float Vector3f::Distance(const Vector3f &vectorA, const Vector3f &vectorB)
     return diff.magnitude();
 }
 
+float Vector3f::Dot(const Vector3f &vectorA, const Vector3f &vectorB)
+{
+    return (vectorA.x * vectorB.x) + (vectorA.y * vectorB.y) + (vectorA.z * vectorB.z);
+}
+
 Vector3f Vector3f::One()
 {
     return Vector3f(1.f, 1.f, 1.f);
@@ -166,12 +164,6 @@ Vector2f::Vector2f(const float X, const float Y)
     y = Y;
 }
 
-Vector2f::Vector2f(const Vector2f &vector)
-{
-    x = vector.x;
-    y = vector.y;
-}
-
 Vector2f Vector2f::operator+(const Vector2f &vector) const
 {
     return Vector2f(x + vector.x, y + vector.y);
@@ -192,11 +184,6 @@ Vector2f Vector2f::operator/(const float &value) const
     return Vector2f(x / value, y / value);
 }
 
-Vector2f Vector2f::operator=(const Vector2f &vector)
-{
-    return Vector2f(vector);
-}
-
 Vector2f Vector2f::operator+=(const Vector2f &vector)
 {
     x += vector.x;
@@ -231,7 +218,12 @@ Vector2f Vector2f::operator/=(const float &value)
 
 Vector2f Vector2f::normalized() const
 {
-    float ratio = 1 / magnitude();
+    // Vecteur nul : pas de direction, on évite de propager NaN
+    float length = magnitude();
+    if (length == 0.0f)
+        return Zero();
+
+    float ratio = 1 / length;
 
     return Vector2f(x * ratio, y * ratio);
 }
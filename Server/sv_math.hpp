@@ -6,7 +6,7 @@ struct Vector3f
     Vector3f();
     Vector3f(const float value);
     Vector3f(const float x, const float y, const float z);
-    Vector3f(const Vector3f& vector);
+    Vector3f(const Vector3f& vector) = default;
     Vector3f(Vector3f&&) = default;
     ~Vector3f() = default;
 
@@ -15,7 +15,7 @@ struct Vector3f
     Vector3f operator*(const float& value) const;
     Vector3f operator/(const float& value) const;
 
-    Vector3f operator=(const Vector3f& vector);
+    Vector3f& operator=(const Vector3f& vector) = default;
     Vector3f operator+=(const Vector3f& vector);
     Vector3f operator-=(const Vector3f& vector);
     Vector3f operator*=(const float& value);
@@ -26,6 +26,7 @@ struct Vector3f
 
 
     static float Distance(const Vector3f& vectorA, const Vector3f& vectorB);
+    static float Dot(const Vector3f& vectorA, const Vector3f& vectorB);
 
     static Vector3f One();
     static Vector3f Zero();
@@ -48,7 +49,7 @@ struct Vector2f
     Vector2f();
     Vector2f(const float value);
     Vector2f(const float x, const float y);
-    Vector2f(const Vector2f& vector);
+    Vector2f(const Vector2f& vector) = default;
     Vector2f(Vector2f&&) = default;
     ~Vector2f() = default;
 
@@ -57,7 +58,7 @@ struct Vector2f
     Vector2f operator*(const float& value) const;
     Vector2f operator/(const float& value) const;
 
-    Vector2f operator=(const Vector2f& vector);
+    Vector2f& operator=(const Vector2f& vector) = default;
     Vector2f operator+=(const Vector2f& vector);
     Vector2f operator-=(const Vector2f& vector);
     Vector2f operator*=(const float& value);
@@ -0,0 +1,336 @@
+#include "sv_memory.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <enet6/enet.h>
+
+namespace
+{
+    constexpr std::uint32_t LargeSizeClass = 0xFFFFFFFF;
+    constexpr std::uint32_t NoOwner = 0xFFFFFFFF;
+
+    // Garde la mémoire rendue alignée comme malloc
+    struct alignas(alignof(std::max_align_t)) BlockHeader
+    {
+        std::uint32_t sizeClass;
+        std::uint32_t size;
+        std::uint32_t owner; // Emplacement de retour du thread qui a alloué le bloc
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Blocs libérés par d'autres threads, en attente de retour dans le cache de leur propriétaire.
+    // Plusieurs producteurs empilent, le propriétaire reprend toute la pile d'un coup : pas d'ABA.
+    // Le lien est écrit dans la donnée du bloc, le header reste intact pour retrouver la classe de taille
+    struct alignas(64) ReturnList
+    {
+        std::atomic<BlockHeader*> head = nullptr;
+        std::atomic<bool> claimed = false;
+    };
+
+    static_assert(PoolMinBlockSize >= sizeof(BlockHeader*));
+
+    std::array<ReturnList, PoolMaxThreads> s_returnLists;
+
+    BlockHeader*& ReturnLink(BlockHeader* a_header)
+    {
+        return *reinterpret_cast<BlockHeader**>(a_header + 1);
+    }
+
+    struct SharedStats
+    {
+        std::atomic<std::uint64_t> allocations = 0;
+        std::atomic<std::uint64_t> frees = 0;
+        std::atomic<std::uint64_t> poolHits = 0;
+        std::atomic<std::uint64_t> poolMisses = 0;
+        std::atomic<std::uint64_t> largeAllocations = 0;
+        std::atomic<std::uint64_t> remoteFrees = 0;
+        std::atomic<std::int64_t> bytesInUse = 0;
+    };
+
+    SharedStats s_stats;
+
+    // Reste valide après la destruction du cache (type trivial), ENet peut encore libérer à la sortie du thread
+    thread_local bool t_cacheDestroyed = false;
+
+    // Chaque thread garde ses propres listes libres : aucun verrou sur le chemin d'allocation
+    struct ThreadCache
+    {
+        std::array<FreeBlock*, PoolSizeClassCount> heads{};
+        std::array<std::size_t, PoolSizeClassCount> counts{};
+        std::uint32_t owner = NoOwner;
+
+        ThreadCache()
+        {
+            for (std::uint32_t i = 0; i < PoolMaxThreads; ++i)
+            {
+                bool expected = false;
+                if (s_returnLists[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                {
+                    owner = i;
+                    break;
+                }
+            }
+        }
+
+        // Range les blocs rendus par les autres threads dans les listes libres, le surplus est rendu au système
+        void TakeReturned()
+        {
+            if (owner == NoOwner)
+                return;
+
+            BlockHeader* header = s_returnLists[owner].head.exchange(nullptr, std::memory_order_acquire);
+            while (header != nullptr)
+            {
+                BlockHeader* next = ReturnLink(header);
+                std::uint32_t sizeClass = header->sizeClass;
+
+                if (counts[sizeClass] < PoolMaxCachedBlocks)
+                {
+                    FreeBlock* block = reinterpret_cast<FreeBlock*>(header);
+                    block->next = heads[sizeClass];
+                    heads[sizeClass] = block;
+                    ++counts[sizeClass];
+                }
+                else
+                {
+                    std::free(header);
+                }
+
+                header = next;
+            }
+        }
+
+        ~ThreadCache()
+        {
+            t_cacheDestroyed = true;
+
+            if (owner != NoOwner)
+            {
+                // Un bloc rendu juste après reste dans la pile jusqu'à ce qu'un nouveau thread reprenne l'emplacement
+                s_returnLists[owner].claimed.store(false, std::memory_order_release);
+
+                BlockHeader* header = s_returnLists[owner].head.exchange(nullptr, std::memory_order_acquire);
+                while (header != nullptr)
+                {
+                    BlockHeader* next = ReturnLink(header);
+                    std::free(header);
+                    header = next;
+                }
+            }
+
+            for (FreeBlock* block : heads)
+            {
+                while (block != nullptr)
+                {
+                    FreeBlock* next = block->next;
+                    std::free(block);
+                    block = next;
+                }
+            }
+        }
+    };
+
+    thread_local ThreadCache t_cache;
+
+    std::uint32_t GetSizeClass(std::size_t size)
+    {
+        std::uint32_t sizeClass = 0;
+        std::size_t blockSize = PoolMinBlockSize;
+        while (blockSize < size)
+        {
+            blockSize <<= 1;
+            ++sizeClass;
+        }
+
+        return sizeClass;
+    }
+
+    std::size_t GetBlockSize(std::uint32_t sizeClass)
+    {
+        return PoolMinBlockSize << sizeClass;
+    }
+}
+
+void* pool_malloc(std::size_t size)
+{
+    s_stats.allocations.fetch_add(1, std::memory_order_relaxed);
+    s_stats.bytesInUse.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+
+    if (size > PoolMaxBlockSize || t_cacheDestroyed)
+    {
+        s_stats.largeAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        BlockHeader* header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+        if (header == nullptr)
+            return nullptr;
+
+        header->sizeClass = LargeSizeClass;
+        header->size = static_cast<std::uint32_t>(size);
+        header->owner = NoOwner;
+        return header + 1;
+    }
+
+    std::uint32_t sizeClass = GetSizeClass(size);
+
+    if (t_cache.heads[sizeClass] == nullptr)
+        t_cache.TakeReturned();
+
+    void* block = t_cache.heads[sizeClass];
+    if (block != nullptr)
+    {
+        t_cache.heads[sizeClass] = t_cache.heads[sizeClass]->next;
+        --t_cache.counts[sizeClass];
+
+        s_stats.poolHits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        block = std::malloc(sizeof(BlockHeader) + GetBlockSize(sizeClass));
+        if (block == nullptr)
+            return nullptr;
+
+        s_stats.poolMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+    header->sizeClass = sizeClass;
+    header->size = static_cast<std::uint32_t>(size);
+    header->owner = t_cache.owner;
+    return header + 1;
+}
+
+void pool_free(void* memory)
+{
+    if (memory == nullptr)
+        return;
+
+    BlockHeader* header = static_cast<BlockHeader*>(memory) - 1;
+
+    s_stats.frees.fetch_add(1, std::memory_order_relaxed);
+    s_stats.bytesInUse.fetch_sub(static_cast<std::int64_t>(header->size), std::memory_order_relaxed);
+
+    std::uint32_t sizeClass = header->sizeClass;
+    if (sizeClass == LargeSizeClass)
+    {
+        std::free(header);
+        return;
+    }
+
+    // Paquets ENet alloués par la simulation et les encodeurs mais libérés par le thread réseau :
+    // le bloc retourne au cache qui l'a fourni, sinon ce cache ne se remplirait jamais
+    std::uint32_t owner = header->owner;
+    if (owner != NoOwner && (t_cacheDestroyed || owner != t_cache.owner))
+    {
+        ReturnList& returnList = s_returnLists[owner];
+        if (returnList.claimed.load(std::memory_order_acquire))
+        {
+            BlockHeader* head = returnList.head.load(std::memory_order_relaxed);
+            do
+            {
+                ReturnLink(header) = head;
+            } while (!returnList.head.compare_exchange_weak(head, header, std::memory_order_release, std::memory_order_relaxed));
+
+            s_stats.remoteFrees.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    if (t_cacheDestroyed || t_cache.counts[sizeClass] >= PoolMaxCachedBlocks)
+    {
+        std::free(header);
+        return;
+    }
+
+    // Le header est écrasé par le lien de la liste libre, il sera réécrit à la prochaine allocation
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(header);
+    block->next = t_cache.heads[sizeClass];
+    t_cache.heads[sizeClass] = block;
+    ++t_cache.counts[sizeClass];
+}
+
+AllocatorStats GetAllocatorStats()
+{
+    AllocatorStats stats;
+    stats.allocations = s_stats.allocations.load(std::memory_order_relaxed);
+    stats.frees = s_stats.frees.load(std::memory_order_relaxed);
+    stats.poolHits = s_stats.poolHits.load(std::memory_order_relaxed);
+    stats.poolMisses = s_stats.poolMisses.load(std::memory_order_relaxed);
+    stats.largeAllocations = s_stats.largeAllocations.load(std::memory_order_relaxed);
+    stats.remoteFrees = s_stats.remoteFrees.load(std::memory_order_relaxed);
+    stats.bytesInUse = s_stats.bytesInUse.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void PrintAllocatorStats(std::ostream& stream)
+{
+    AllocatorStats stats = GetAllocatorStats();
+
+    std::uint64_t pooled = stats.poolHits + stats.poolMisses;
+    double hitRatio = pooled > 0 ? 100.0 * static_cast<double>(stats.poolHits) / static_cast<double>(pooled) : 0.0;
+
+    stream << "Allocator : " << stats.allocations << " allocs, " << stats.frees << " frees, "
+           << hitRatio << "% pool hits, " << stats.largeAllocations << " large, "
+           << stats.remoteFrees << " returned to their thread, "
+           << stats.bytesInUse << " bytes in use\n" << std::flush;
+}
+
+void* RoomArena::PoolResource::do_allocate(std::size_t a_bytes, std::size_t a_alignment)
+{
+    // Les pools alignent comme malloc, au-delà on passe par l'allocateur standard
+    if (a_alignment > alignof(std::max_align_t))
+        return std::pmr::new_delete_resource()->allocate(a_bytes, a_alignment);
+
+    void* memory = pool_malloc(a_bytes);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+
+    bytesInUse += static_cast<std::int64_t>(a_bytes);
+    return memory;
+}
+
+void RoomArena::PoolResource::do_deallocate(void* a_memory, std::size_t a_bytes, std::size_t a_alignment)
+{
+    if (a_alignment > alignof(std::max_align_t))
+    {
+        std::pmr::new_delete_resource()->deallocate(a_memory, a_bytes, a_alignment);
+        return;
+    }
+
+    pool_free(a_memory);
+    bytesInUse -= static_cast<std::int64_t>(a_bytes);
+}
+
+RoomArena::RoomArena() :
+    m_chunks(RoomArenaChunkSize, &m_upstream),
+    m_pool(std::pmr::pool_options{ 0, RoomArenaLargestBlock }, &m_chunks)
+{
+}
+
+void RoomArena::Reset()
+{
+    m_pool.release();
+    m_chunks.release();
+    ++m_resets;
+}
+
+bool initialize_enet_with_pools()
+{
+    ENetCallbacks callbacks = {};
+    callbacks.malloc = [](size_t size) { return pool_malloc(size); };
+    callbacks.free = [](void* memory) { pool_free(memory); };
+    callbacks.no_memory = []()
+    {
+        std::cerr << "ERROR -> ENet : out of memory\n" << std::flush;
+        std::abort();
+    };
+
+    return enet_initialize_with_callbacks(ENET_VERSION, &callbacks) == 0;
+}
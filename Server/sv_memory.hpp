@@ -0,0 +1,80 @@
+#ifndef _SV_MEMORY_HPP
+#define _SV_MEMORY_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory_resource>
+
+// Classes de taille des pools : 32, 64, ..., 4096 octets. Au-delà on passe directement par malloc
+constexpr std::size_t PoolMinBlockSize = 32;
+constexpr std::size_t PoolSizeClassCount = 8;
+constexpr std::size_t PoolMaxBlockSize = PoolMinBlockSize << (PoolSizeClassCount - 1);
+
+// Nombre max de blocs gardés par classe et par thread, le surplus est rendu au système
+constexpr std::size_t PoolMaxCachedBlocks = 1024;
+
+// Threads pouvant recevoir en retour les blocs qu'ils ont alloués et qu'un autre thread libère.
+// Au-delà, les blocs d'un thread restent au thread qui les libère
+constexpr std::size_t PoolMaxThreads = 64;
+
+// Arène d'une salle : chunks demandés aux pools, blocs plus grands que RoomArenaLargestBlock perdus jusqu'au Reset
+constexpr std::size_t RoomArenaChunkSize = 16 * 1024;
+constexpr std::size_t RoomArenaLargestBlock = 64 * 1024;
+
+struct AllocatorStats
+{
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t poolHits = 0;   // Bloc recyclé depuis un pool
+    std::uint64_t poolMisses = 0; // Pool vide, bloc alloué par malloc
+    std::uint64_t largeAllocations = 0;
+    std::uint64_t remoteFrees = 0; // Bloc libéré par un autre thread, rendu au cache de son propriétaire
+    std::int64_t bytesInUse = 0;
+};
+
+void* pool_malloc(std::size_t size);
+void pool_free(void* memory);
+
+AllocatorStats GetAllocatorStats();
+void PrintAllocatorStats(std::ostream& stream);
+
+// Mémoire de la partie en cours d'une salle, à un seul thread (celui de la simulation).
+// Les conteneurs y allouent via Resource() : un bloc libéré en cours de partie est recyclé par l'arène,
+// tout le reste est rendu d'un coup par Reset à la fin de la partie
+class RoomArena
+{
+public:
+    RoomArena();
+    RoomArena(const RoomArena&) = delete;
+    RoomArena& operator=(const RoomArena&) = delete;
+
+    std::pmr::memory_resource* Resource() { return &m_pool; }
+
+    // Aucun conteneur ne doit encore tenir de mémoire de l'arène : l'arène ne détruit rien elle-même
+    void Reset();
+
+    std::int64_t ReservedBytes() const { return m_upstream.bytesInUse; } // Chunks pris aux pools
+    std::uint64_t ResetCount() const { return m_resets; }
+
+private:
+    // pool_malloc vu comme une memory_resource, pour que les chunks apparaissent dans les stats de l'allocateur
+    struct PoolResource : std::pmr::memory_resource
+    {
+        std::int64_t bytesInUse = 0;
+
+        void* do_allocate(std::size_t a_bytes, std::size_t a_alignment) override;
+        void do_deallocate(void* a_memory, std::size_t a_bytes, std::size_t a_alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& a_other) const noexcept override { return this == &a_other; }
+    };
+
+    PoolResource m_upstream;
+    std::pmr::monotonic_buffer_resource m_chunks;
+    std::pmr::unsynchronized_pool_resource m_pool;
+    std::uint64_t m_resets = 0;
+};
+
+// Remplace enet_initialize : ENet alloue alors packets et buffers via les pools
+bool initialize_enet_with_pools();
+
+#endif //_SV_MEMORY_HPP
@@ -0,0 +1,201 @@
+#include "sv_mmap.hpp"
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_writable = std::exchange(other.m_writable, false);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "ERROR -> MappedFile::Open : Cannot open " << path << "\n" << std::flush;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        std::cerr << "ERROR -> MappedFile::Open : " << path << " is empty\n" << std::flush;
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "ERROR -> MappedFile::Open : Cannot map " << path << "\n" << std::flush;
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "ERROR -> MappedFile::Open : Cannot open " << path << "\n" << std::flush;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        std::cerr << "ERROR -> MappedFile::Open : " << path << " is empty\n" << std::flush;
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // Le mapping reste valide sans le descripteur
+    if (data == MAP_FAILED)
+    {
+        std::cerr << "ERROR -> MappedFile::Open : Cannot map " << path << "\n" << std::flush;
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(info.st_size);
+#endif
+
+    m_data = static_cast<const std::uint8_t*>(data);
+    return true;
+}
+
+bool MappedFile::Create(const std::string& path, std::size_t size)
+{
+    Close();
+
+    if (size == 0)
+    {
+        std::cerr << "ERROR -> MappedFile::Create : Cannot map an empty file (" << path << ")\n" << std::flush;
+        return false;
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "ERROR -> MappedFile::Create : Cannot create " << path << "\n" << std::flush;
+        return false;
+    }
+
+    LARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = static_cast<LONGLONG>(size);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, mappingSize.HighPart, mappingSize.LowPart, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (data == nullptr)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "ERROR -> MappedFile::Create : Cannot map " << path << "\n" << std::flush;
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+#else
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "ERROR -> MappedFile::Create : Cannot create " << path << "\n" << std::flush;
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        std::cerr << "ERROR -> MappedFile::Create : Cannot resize " << path << "\n" << std::flush;
+        return false;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        std::cerr << "ERROR -> MappedFile::Create : Cannot map " << path << "\n" << std::flush;
+        return false;
+    }
+#endif
+
+    m_data = static_cast<const std::uint8_t*>(data);
+    m_size = size;
+    m_writable = true;
+    return true;
+}
+
+bool MappedFile::Flush()
+{
+    if (m_data == nullptr || !m_writable)
+        return false;
+
+#ifdef _WIN32
+    return FlushViewOfFile(m_data, m_size) && FlushFileBuffers(m_file);
+#else
+    return msync(const_cast<std::uint8_t*>(m_data), m_size, MS_SYNC) == 0;
+#endif
+}
+
+void MappedFile::Close()
+{
+    if (m_data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    munmap(const_cast<std::uint8_t*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_writable = false;
+}
@@ -0,0 +1,44 @@
+#ifndef _SV_MMAP_HPP
+#define _SV_MMAP_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Fichier mappé en mémoire, les pages sont chargées à la demande par l'OS
+// Open : lecture seule. Create : fichier (re)créé à la taille donnée, mapping partagé en écriture
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::string& path);
+    bool Create(const std::string& path, std::size_t size);
+    void Close();
+
+    // Écrit les pages modifiées sur le disque (mapping créé par Create uniquement)
+    bool Flush();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const std::uint8_t* Data() const { return m_data; }
+    std::uint8_t* MutableData() { return m_writable ? const_cast<std::uint8_t*>(m_data) : nullptr; }
+    std::size_t Size() const { return m_size; }
+
+private:
+    const std::uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_writable = false;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+#endif //_SV_MMAP_HPP
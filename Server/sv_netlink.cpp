@@ -0,0 +1,258 @@
+#include "sv_netlink.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <thread>
+
+#include "sv_compress.hpp"
+
+namespace
+{
+    thread_local NetLink* t_link = nullptr;
+
+    std::uint32_t GetConnection(const ENetPeer* a_peer)
+    {
+        return static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(a_peer->data));
+    }
+
+    // La file ne reste pleine que si l'autre thread est bloqué ou débordé : on attend un peu puis on abandonne
+    template<typename Queue, typename T, typename Wait> bool PushOrWait(Queue& a_queue, T&& a_value, Wait&& a_wait)
+    {
+        auto giveUp = std::chrono::steady_clock::now() + std::chrono::milliseconds(NetQueueFullTimeout);
+        while (!a_queue.TryPush(std::move(a_value)))
+        {
+            if (std::chrono::steady_clock::now() >= giveUp)
+                return false;
+
+            a_wait();
+        }
+
+        return true;
+    }
+}
+
+void NetLink::HandleEvent(const ENetEvent& a_event)
+{
+    switch (a_event.type)
+    {
+        case ENET_EVENT_TYPE_CONNECT:
+        {
+            std::uint32_t connection = m_nextConnection++;
+            if (m_nextConnection == 0)
+                m_nextConnection = 1;
+
+            a_event.peer->data = reinterpret_cast<void*>(static_cast<std::uintptr_t>(connection));
+            PushCommand({ a_event.peer, connection, NetConnect{ a_event.peer->mtu, static_cast<std::uint8_t>(a_event.peer->channelCount) } });
+            break;
+        }
+        case ENET_EVENT_TYPE_DISCONNECT:
+        case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
+        {
+            // 0 : déjà coupé à la demande de la simulation
+            std::uint32_t connection = GetConnection(a_event.peer);
+            if (connection == 0)
+                break;
+
+            a_event.peer->data = nullptr;
+            PushCommand({ a_event.peer, connection, NetDisconnect{ a_event.type == ENET_EVENT_TYPE_DISCONNECT_TIMEOUT } });
+            break;
+        }
+        case ENET_EVENT_TYPE_RECEIVE:
+        {
+            std::uint32_t connection = GetConnection(a_event.peer);
+            if (connection != 0)
+                m_content.assign(a_event.packet->data, a_event.packet->data + a_event.packet->dataLength);
+
+            enet_packet_destroy(a_event.packet);
+
+            if (connection == 0 || m_content.empty())
+                break;
+
+            if (static_cast<OP_CODE>(m_content[0]) != OP_CODE::Bundle)
+            {
+                DecodeMessage(a_event.peer, connection, m_content, 0, true);
+                break;
+            }
+
+            // Bundle : chaque message est précédé de sa taille
+            std::size_t offset = 1;
+            while (offset + BundleFrameHeaderSize <= m_content.size())
+            {
+                std::size_t length = Deserialize_u16(m_content, offset);
+                if (length == 0 || offset + length > m_content.size())
+                {
+                    std::cerr << "ERROR -> NetLink::HandleEvent : malformed bundle from connection #" << connection << "\n" << std::flush;
+                    break;
+                }
+
+                DecodeMessage(a_event.peer, connection, m_content, offset, true);
+                offset += length;
+            }
+            break;
+        }
+        case ENET_EVENT_TYPE_NONE:
+        default:
+        {
+            // n'est pas censé se produire
+            std::cout << "unexpected ENet event\n" << std::flush;
+            break;
+        }
+    }
+}
+
+void NetLink::DecodeMessage(ENetPeer* a_peer, std::uint32_t a_connection, const byteArray_t& a_message, std::size_t a_offset, bool a_allowCompressed)
+{
+    OP_CODE opcode = static_cast<OP_CODE>(Deserialize_u8(a_message, a_offset));
+    switch (opcode)
+    {
+        case OP_CODE::C_PlayerInfo:
+            PushCommand({ a_peer, a_connection, PlayerInfoPacket::Deserialize(a_message, a_offset) });
+            break;
+
+        case OP_CODE::C_PlayerInput:
+            PushCommand({ a_peer, a_connection, PlayerInputPacket::Deserialize(a_message, a_offset) });
+            break;
+
+        case OP_CODE::C_TimeSync:
+            PushCommand({ a_peer, a_connection, TimeSyncRequestPacket::Deserialize(a_message, a_offset) });
+            break;
+
+        case OP_CODE::C_RosterResync:
+            PushCommand({ a_peer, a_connection, RosterResyncPacket::Deserialize(a_message, a_offset) });
+            break;
+
+        case OP_CODE::C_SnapshotResync:
+            PushCommand({ a_peer, a_connection, SnapshotResyncPacket::Deserialize(a_message, a_offset) });
+            break;
+
+        case OP_CODE::Compressed:
+        {
+            byteArray_t decompressed;
+            if (!a_allowCompressed || !DecompressMessage(std::span<const std::uint8_t>(a_message).subspan(a_offset), decompressed) || decompressed.empty()
+                || static_cast<OP_CODE>(decompressed[0]) == OP_CODE::Bundle)
+            {
+                std::cerr << "ERROR -> NetLink::DecodeMessage : invalid compressed message from connection #" << a_connection << "\n" << std::flush;
+                break;
+            }
+
+            DecodeMessage(a_peer, a_connection, decompressed, 0, false);
+            break;
+        }
+
+        default:
+            PushCommand({ a_peer, a_connection, NetUnexpected{ opcode } });
+            break;
+    }
+}
+
+bool NetLink::DeliverOutputs()
+{
+    bool sent = false;
+
+    NetOutput output;
+    while (m_outputs.TryPop(output))
+    {
+        // Client parti depuis : le peer a pu être réattribué à un autre
+        if (GetConnection(output.peer) != output.connection)
+        {
+            if (output.packet != nullptr)
+                enet_packet_destroy(output.packet);
+            continue;
+        }
+
+        if (output.packet == nullptr)
+        {
+            enet_peer_disconnect_now(output.peer, output.disconnectData);
+            output.peer->data = nullptr;
+            continue;
+        }
+
+        if (enet_peer_send(output.peer, output.channel, output.packet) < 0)
+            enet_packet_destroy(output.packet);
+        else
+            sent = true;
+    }
+
+    return sent;
+}
+
+void NetLink::Send(ENetPeer* a_peer, std::uint32_t a_connection, enet_uint8 a_channel, ENetPacket* a_packet)
+{
+    PushOutput({ a_peer, a_connection, a_packet, a_channel, 0 });
+}
+
+void NetLink::Disconnect(ENetPeer* a_peer, std::uint32_t a_connection, enet_uint32 a_data)
+{
+    PushOutput({ a_peer, a_connection, nullptr, 0, a_data });
+}
+
+bool NetLink::FlushPendingCommands()
+{
+    while (!m_pendingCommands.empty() && m_commands.TryPush(std::move(m_pendingCommands.front())))
+        m_pendingCommands.pop_front();
+
+    return m_pendingCommands.empty();
+}
+
+bool NetLink::FlushPendingOutputs()
+{
+    while (!m_pendingOutputs.empty() && m_outputs.TryPush(std::move(m_pendingOutputs.front())))
+        m_pendingOutputs.pop_front();
+
+    return m_pendingOutputs.empty();
+}
+
+void NetLink::PushCommand(NetCommand&& a_command)
+{
+    a_command.roundTripTime = a_command.peer->roundTripTime;
+
+    // Renvoyés par le client ou remplacés au message suivant : les seuls qu'on peut perdre
+    bool droppable = std::holds_alternative<PlayerInputPacket>(a_command.message) || std::holds_alternative<TimeSyncRequestPacket>(a_command.message)
+        || std::holds_alternative<NetUnexpected>(a_command.message);
+
+    // Le thread réseau continue de vider la sortie en attendant : la simulation n'est jamais bloquée par lui
+    if (FlushPendingCommands() && PushOrWait(m_commands, std::move(a_command), [this]
+    {
+        DeliverOutputs();
+        std::this_thread::yield();
+    }))
+        return;
+
+    if (droppable)
+    {
+        std::cerr << "ERROR -> NetLink::PushCommand : command queue full, command dropped\n" << std::flush;
+        return;
+    }
+
+    // Une connexion, une déconnexion ou un message d'état ne se perd jamais : sinon le joueur garde un peer mort ou un peer n'a pas de place
+    m_pendingCommands.push_back(std::move(a_command));
+}
+
+void NetLink::PushOutput(NetOutput&& a_output)
+{
+    ENetPacket* packet = a_output.packet;
+    if (FlushPendingOutputs() && PushOrWait(m_outputs, std::move(a_output), [] { std::this_thread::yield(); }))
+        return;
+
+    if (packet == nullptr)
+    {
+        // Déconnexion : gardée jusqu'à ce que la file ait de la place
+        m_pendingOutputs.push_back(std::move(a_output));
+        return;
+    }
+
+    enet_packet_destroy(packet);
+    std::cerr << "ERROR -> NetLink::PushOutput : output queue full, packet dropped\n" << std::flush;
+}
+
+void bind_thread_netlink(NetLink* a_link)
+{
+    t_link = a_link;
+}
+
+NetLink* get_thread_netlink()
+{
+    return t_link;
+}
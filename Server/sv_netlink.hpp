@@ -0,0 +1,99 @@
+#ifndef _SV_NETLINK_HPP
+#define _SV_NETLINK_HPP 1
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <variant>
+#include <enet6/enet.h>
+
+#include "sv_constant.hpp"
+#include "sv_protocol.hpp"
+#include "sv_queue.hpp"
+
+#pragma region NetCommands
+
+// Réseau -> simulation. Côté simulation un ENetPeer n'est qu'un identifiant, jamais déréférencé :
+// connection distingue deux clients successifs qu'ENet aurait placés sur le même peer
+struct NetConnect
+{
+    std::uint32_t mtu;
+    std::uint8_t channelCount;
+};
+
+struct NetDisconnect
+{
+    bool timeout;
+};
+
+struct NetUnexpected
+{
+    OP_CODE opcode;
+};
+
+using NetMessage = std::variant<NetConnect, NetDisconnect, NetUnexpected, PlayerInfoPacket, PlayerInputPacket, TimeSyncRequestPacket, RosterResyncPacket, SnapshotResyncPacket>;
+
+struct NetCommand
+{
+    ENetPeer* peer = nullptr;
+    std::uint32_t connection = 0;
+    NetMessage message;
+    std::uint32_t roundTripTime = 0; // ms, moyenne d'ENet pour ce peer, relevée par PushCommand
+};
+
+// Simulation -> réseau. packet == nullptr : déconnexion avec disconnectData
+struct NetOutput
+{
+    ENetPeer* peer = nullptr;
+    std::uint32_t connection = 0;
+    ENetPacket* packet = nullptr;
+    enet_uint8 channel = 0;
+    enet_uint32 disconnectData = 0;
+};
+
+#pragma endregion
+
+// Lien entre le thread réseau d'un shard, seul à toucher l'ENetHost, et son thread de simulation
+class NetLink
+{
+public:
+    // Thread réseau : décode l'événement en commandes (bundles et messages compressés sont dépliés ici)
+    void HandleEvent(const ENetEvent& a_event);
+
+    // Thread réseau : remet les packets de la simulation à ENet. Retourne true si au moins un packet est parti
+    bool DeliverOutputs();
+
+    // Thread réseau : repousse dans la file les commandes mises de côté quand elle était pleine. true si il n'en reste plus
+    bool FlushPendingCommands();
+
+    // Thread simulation
+    bool PopCommand(NetCommand& a_command) { return m_commands.TryPop(a_command); }
+    void Send(ENetPeer* a_peer, std::uint32_t a_connection, enet_uint8 a_channel, ENetPacket* a_packet);
+    void Disconnect(ENetPeer* a_peer, std::uint32_t a_connection, enet_uint32 a_data);
+    bool FlushPendingOutputs();
+
+    // Écrite par la simulation après chaque tick (n_clock, en ticks d'horloge) : le thread réseau peut dormir jusque-là
+    std::atomic<std::int64_t> nextDeadline = 0;
+
+private:
+    void PushCommand(NetCommand&& a_command);
+    void PushOutput(NetOutput&& a_output);
+    void DecodeMessage(ENetPeer* a_peer, std::uint32_t a_connection, const byteArray_t& a_message, std::size_t a_offset, bool a_allowCompressed);
+
+    SpscQueue<NetCommand, NetCommandQueueSize> m_commands;
+    SpscQueue<NetOutput, NetOutputQueueSize> m_outputs;
+
+    // File pleine trop longtemps : connexions et déconnexions ne sont jamais perdues, elles attendent ici (côté producteur).
+    // Tant qu'il en reste, les messages qui peuvent se perdre (inputs, synchro d'horloge, packets) sont abandonnés pour garder l'ordre
+    std::deque<NetCommand> m_pendingCommands; // Thread réseau
+    std::deque<NetOutput> m_pendingOutputs;   // Thread simulation
+
+    std::uint32_t m_nextConnection = 1; // Thread réseau, 0 -> peer sans client
+    byteArray_t m_content;
+};
+
+// Lien utilisé par send_to_peer / disconnect_peer sur ce thread, nullptr -> appels ENet directs
+void bind_thread_netlink(NetLink* a_link);
+NetLink* get_thread_netlink();
+
+#endif //_SV_NETLINK_HPP
@@ -0,0 +1,319 @@
+#include "sv_network.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include "sv_compress.hpp"
+#include "sv_netlink.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <linux/filter.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::uint32_t s_serverTimeOffset = 0;
+}
+
+std::uint32_t get_server_time()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return static_cast<std::uint32_t>(elapsed.count()) + s_serverTimeOffset;
+}
+
+void resume_server_time(std::uint32_t a_time)
+{
+    s_serverTimeOffset = 0;
+    s_serverTimeOffset = a_time - get_server_time();
+}
+
+std::int64_t create_shard_socket(std::uint16_t a_port)
+{
+#if defined(_WIN32) || !defined(SO_REUSEPORT)
+    (void)a_port;
+    std::cerr << "ERROR -> create_shard_socket : SO_REUSEPORT is not available on this platform\n" << std::flush;
+    return -1;
+#else
+    int fd = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        std::cerr << "ERROR -> create_shard_socket : Cannot create socket\n" << std::flush;
+        return -1;
+    }
+
+    // Mêmes réglages que les sockets d'ENet : double pile, non bloquant, buffers agrandis
+    int no = 0;
+    int yes = 1;
+    int receiveBufferSize = ENET_HOST_RECEIVE_BUFFER_SIZE;
+    int sendBufferSize = ENET_HOST_SEND_BUFFER_SIZE;
+    int flags = fcntl(fd, F_GETFL);
+
+    sockaddr_in6 address{};
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(a_port);
+
+    if (setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &no, sizeof(no)) != 0
+        || setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) != 0
+        || setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize)) != 0
+        || setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize)) != 0
+        || flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0
+        || bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        std::cerr << "ERROR -> create_shard_socket : Cannot bind a shared socket on port " << a_port << "\n" << std::flush;
+        return -1;
+    }
+
+    return fd;
+#endif
+}
+
+bool attach_shard_selector(std::int64_t a_socket, std::size_t a_shardCount)
+{
+#if defined(_WIN32) || !defined(SO_ATTACH_REUSEPORT_CBPF)
+    (void)a_socket; (void)a_shardCount;
+    std::cerr << "ERROR -> attach_shard_selector : SO_ATTACH_REUSEPORT_CBPF is not available on this platform\n" << std::flush;
+    return false;
+#else
+    // Le filtre voit la charge UDP, l'en-tête IP est lu à SKF_NET_OFF. Socket double pile : en-tête IPv4 ou IPv6.
+    // Résultat = index du socket dans le groupe, dans l'ordre des bind : celui des shards
+    constexpr std::uint32_t ipVersion = static_cast<std::uint32_t>(SKF_NET_OFF);
+    constexpr std::uint32_t ipv4Source = static_cast<std::uint32_t>(SKF_NET_OFF + 12);
+    constexpr std::uint32_t ipv6Source = static_cast<std::uint32_t>(SKF_NET_OFF + 8);
+
+    sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, ipVersion),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 4),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 6, 0, 11),
+        // IPv6 : les 4 mots de l'adresse source combinés
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ipv6Source),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ipv6Source + 4),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ipv6Source + 8),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ipv6Source + 12),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_JUMP(BPF_JMP | BPF_JA, 1, 0, 0),
+        // IPv4
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ipv4Source),
+        // Mélange (Fibonacci) puis modulo : des adresses voisines se répartissent sur tous les shards
+        BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9E3779B1u),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<std::uint32_t>(a_shardCount)),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+
+    sock_fprog program{ static_cast<unsigned short>(std::size(code)), code };
+    if (setsockopt(static_cast<int>(a_socket), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) != 0)
+    {
+        std::cerr << "ERROR -> attach_shard_selector : Cannot attach the shard filter\n" << std::flush;
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+void refill_send_budget(PlayerData& a_player, std::uint32_t a_peerBandwidth, float a_deltaTime)
+{
+    if (a_peerBandwidth == 0)
+    {
+        a_player.sendBudget = std::numeric_limits<std::int32_t>::max();
+        return;
+    }
+
+    // Le budget max évite qu'un peer silencieux accumule de quoi saturer le lien d'un coup
+    std::int64_t refill = static_cast<std::int64_t>(a_peerBandwidth * a_deltaTime);
+    std::int64_t burst = std::max<std::int64_t>(refill * PeerBudgetBurstTicks, 1);
+    std::int64_t budget = static_cast<std::int64_t>(a_player.sendBudget) + refill;
+
+    a_player.sendBudget = static_cast<std::int32_t>(std::min(budget, burst));
+}
+
+bool has_send_budget(const PlayerData& a_player)
+{
+    return a_player.sendBudget > 0;
+}
+
+void charge_send_budget(PlayerData& a_player, std::size_t a_size)
+{
+    if (a_player.sendBudget != std::numeric_limits<std::int32_t>::max())
+        a_player.sendBudget -= static_cast<std::int32_t>(a_size);
+}
+
+bool send_to_peer(PlayerData& a_player, CHANNEL a_channel, ENetPacket* a_packet)
+{
+    if (a_player.peer == nullptr)
+    {
+        enet_packet_destroy(a_packet);
+        return false;
+    }
+
+    // Un ancien client n'ouvre qu'un canal, tout passe alors par le canal de contrôle
+    enet_uint8 channelId = static_cast<enet_uint8>(a_channel);
+    if (channelId >= a_player.channelCount)
+        channelId = static_cast<enet_uint8>(CHANNEL::Control);
+
+    // Thread de simulation : c'est le thread réseau qui appellera ENet
+    if (NetLink* link = get_thread_netlink())
+    {
+        link->Send(a_player.peer, a_player.connection, channelId, a_packet);
+        return true;
+    }
+
+    if (enet_peer_send(a_player.peer, channelId, a_packet) < 0)
+    {
+        enet_packet_destroy(a_packet);
+        return false;
+    }
+
+    return true;
+}
+
+void disconnect_peer(PlayerData& a_player, enet_uint32 a_data)
+{
+    if (a_player.peer == nullptr)
+        return;
+
+    if (NetLink* link = get_thread_netlink())
+        link->Disconnect(a_player.peer, a_player.connection, a_data);
+    else
+    {
+        enet_peer_disconnect_now(a_player.peer, a_data);
+        a_player.peer->data = nullptr;
+    }
+
+    a_player.peer = nullptr;
+}
+
+bool send_to_player(PlayerData& a_player, CHANNEL a_channel, ENetPacket* a_packet, SEND_PRIORITY a_priority)
+{
+    if (a_priority == SEND_PRIORITY::Low && !has_send_budget(a_player))
+    {
+        enet_packet_destroy(a_packet);
+        return false;
+    }
+
+    std::size_t packetSize = a_packet->dataLength;
+    if (!send_to_peer(a_player, a_channel, a_packet))
+        return false;
+
+    charge_send_budget(a_player, packetSize);
+    return true;
+}
+
+void send_pending_packets(PlayerData& a_player, std::vector<PendingPacket>& a_packets)
+{
+    for (PendingPacket& pending : a_packets)
+        send_to_peer(a_player, pending.channel, pending.packet);
+
+    a_packets.clear();
+}
+
+#pragma region PacketBundler
+
+void PacketBundler::Begin(PlayerData& a_player, std::size_t a_compressionThreshold, std::vector<PendingPacket>* a_pending)
+{
+    m_player = &a_player;
+    m_pending = a_pending;
+    m_compressionThreshold = (a_player.capabilities & CAPABILITY_Compression) ? a_compressionThreshold : 0;
+
+    m_maxSize = BundleMaxSize;
+    if (a_player.peer != nullptr && a_player.mtu > BundleENetOverhead)
+        m_maxSize = std::min<std::size_t>(BundleMaxSize, a_player.mtu - BundleENetOverhead);
+}
+
+bool PacketBundler::AddMessage(CHANNEL a_channel, enet_uint32 a_flags)
+{
+    // Seuls les gros messages fiables valent le coût : les snapshots sont petits et périmés au tick suivant
+    if (m_compressionThreshold > 0 && (a_flags & ENET_PACKET_FLAG_RELIABLE) && m_message.size() >= m_compressionThreshold)
+        CompressMessage(m_message);
+
+    auto it = std::find_if(m_outboxes.begin(), m_outboxes.end(), [&](const Outbox& outbox) { return outbox.channel == a_channel && outbox.flags == a_flags; });
+    if (it == m_outboxes.end())
+    {
+        it = m_outboxes.emplace(m_outboxes.end());
+        it->channel = a_channel;
+        it->flags = a_flags;
+    }
+    Outbox& outbox = *it;
+
+    // Trop gros pour être regroupé : part seul, ENet le fragmente. Le bundle en attente part avant pour garder l'ordre
+    if (m_message.size() + 1 + BundleFrameHeaderSize > m_maxSize)
+    {
+        Send(outbox);
+
+        std::size_t size = m_message.size();
+        if (!Emit(a_channel, enet_packet_create(m_message.data(), size, a_flags)))
+            return false;
+
+        charge_send_budget(*m_player, size);
+        return true;
+    }
+
+    if (outbox.buffer.size() + BundleFrameHeaderSize + m_message.size() > m_maxSize)
+        Send(outbox);
+
+    if (outbox.buffer.empty())
+        Serialize_u8(outbox.buffer, static_cast<std::uint8_t>(OP_CODE::Bundle));
+
+    Serialize_u16(outbox.buffer, static_cast<std::uint16_t>(m_message.size()));
+    outbox.buffer.insert(outbox.buffer.end(), m_message.begin(), m_message.end());
+    ++outbox.frameCount;
+
+    // Décompté tout de suite pour que les messages suivants voient le budget restant
+    charge_send_budget(*m_player, BundleFrameHeaderSize + m_message.size());
+    return true;
+}
+
+void PacketBundler::Send(Outbox& a_outbox)
+{
+    if (a_outbox.frameCount == 1)
+    {
+        // Un seul message : on retire l'en-tête de bundle, le packet reste lisible par un client qui ne les gère pas
+        constexpr std::size_t headerSize = 1 + BundleFrameHeaderSize;
+        Emit(a_outbox.channel, enet_packet_create(a_outbox.buffer.data() + headerSize, a_outbox.buffer.size() - headerSize, a_outbox.flags));
+    }
+    else if (a_outbox.frameCount > 1)
+    {
+        Emit(a_outbox.channel, enet_packet_create(a_outbox.buffer.data(), a_outbox.buffer.size(), a_outbox.flags));
+    }
+
+    a_outbox.buffer.clear();
+    a_outbox.frameCount = 0;
+}
+
+bool PacketBundler::Emit(CHANNEL a_channel, ENetPacket* a_packet)
+{
+    if (m_pending == nullptr)
+        return send_to_peer(*m_player, a_channel, a_packet);
+
+    m_pending->push_back({ a_channel, a_packet });
+    return true;
+}
+
+void PacketBundler::Flush()
+{
+    if (m_player == nullptr)
+        return;
+
+    for (Outbox& outbox : m_outboxes)
+        Send(outbox);
+
+    m_player = nullptr;
+    m_pending = nullptr;
+}
+
+#pragma endregion
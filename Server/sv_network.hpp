@@ -0,0 +1,108 @@
+#ifndef _SV_NETWORK_HPP
+#define _SV_NETWORK_HPP 1
+
+#include <cstdint>
+#include <vector>
+#include <enet6/enet.h>
+
+#include "sv_constant.hpp"
+#include "sv_players.hpp"
+#include "sv_protocol.hpp"
+
+// ms écoulées depuis le démarrage du serveur, horloge de référence envoyée aux clients
+std::uint32_t get_server_time();
+
+// Reprend l'horloge là où l'ancien processus l'a laissée (redémarrage à chaud)
+void resume_server_time(std::uint32_t a_time);
+
+// Socket UDP IPv4 + IPv6 lié à a_port avec SO_REUSEPORT, pour qu'un ENetHost par shard partage le port. -1 si impossible
+std::int64_t create_shard_socket(std::uint16_t a_port);
+
+// Choix du shard par le noyau selon l'adresse source seule (filtre BPF sur le groupe SO_REUSEPORT de a_socket) :
+// un client qui revient depuis un autre port retombe sur le même shard. a_socket : premier socket du groupe, shard 0
+bool attach_shard_selector(std::int64_t a_socket, std::size_t a_shardCount);
+
+// Recharge le budget d'envoi du peer pour un tick réseau (peerBandwidth en octets/s, 0 -> illimité)
+void refill_send_budget(PlayerData& a_player, std::uint32_t a_peerBandwidth, float a_deltaTime);
+
+bool has_send_budget(const PlayerData& a_player);
+
+void charge_send_budget(PlayerData& a_player, std::size_t a_size);
+
+// Envoie le packet sur le canal donné, sans toucher au budget. Détruit le packet s'il n'est pas envoyé
+bool send_to_peer(PlayerData& a_player, CHANNEL a_channel, ENetPacket* a_packet);
+
+// Coupe le client tout de suite (a_data transmis au client) et libère player.peer
+void disconnect_peer(PlayerData& a_player, enet_uint32 a_data);
+
+// Envoie le packet sur le canal donné en le décomptant du budget. Détruit le packet s'il n'est pas envoyé
+bool send_to_player(PlayerData& a_player, CHANNEL a_channel, ENetPacket* a_packet, SEND_PRIORITY a_priority);
+
+template<typename T> bool send_packet(PlayerData& a_player, const T& a_packet, SEND_PRIORITY a_priority = T::priority)
+{
+    // Inutile de sérialiser un packet qui sera abandonné
+    if (a_priority == SEND_PRIORITY::Low && !has_send_budget(a_player))
+        return false;
+
+    return send_to_player(a_player, T::channel, build_packet(a_packet, T::flags), a_priority);
+}
+
+// Packet construit par un worker d'encodage, envoyé ensuite par le thread de simulation
+struct PendingPacket
+{
+    CHANNEL channel;
+    ENetPacket* packet;
+};
+
+// Envoie les packets dans l'ordre où ils ont été construits puis vide a_packets. Budget déjà décompté à la construction
+void send_pending_packets(PlayerData& a_player, std::vector<PendingPacket>& a_packets);
+
+// Regroupe les messages d'un tick pour un destinataire : un datagramme par canal et par mode d'envoi,
+// découpé pour rester sous le MTU. Un bundle d'un seul message part sans en-tête de bundle
+class PacketBundler
+{
+public:
+    // a_compressionThreshold : taille à partir de laquelle les messages fiables sont compressés, si le client le gère (0 -> jamais)
+    // a_pending : les packets y sont rangés au lieu de partir, le bundler ne touche alors qu'à a_player et peut tourner sur un worker
+    void Begin(PlayerData& a_player, std::size_t a_compressionThreshold = 0, std::vector<PendingPacket>* a_pending = nullptr);
+
+    template<typename T> bool Add(const T& a_packet, SEND_PRIORITY a_priority = T::priority, enet_uint32 a_flags = T::flags)
+    {
+        if (m_player == nullptr || m_player->peer == nullptr)
+            return false;
+
+        // Inutile de sérialiser un message qui sera abandonné
+        if (a_priority == SEND_PRIORITY::Low && !has_send_budget(*m_player))
+            return false;
+
+        m_message.clear();
+        serialize_message(a_packet, m_message);
+
+        return AddMessage(T::channel, a_flags);
+    }
+
+    // Envoie les bundles en attente
+    void Flush();
+
+private:
+    struct Outbox
+    {
+        CHANNEL channel;
+        enet_uint32 flags;
+        byteArray_t buffer;
+        std::size_t frameCount = 0;
+    };
+
+    bool AddMessage(CHANNEL a_channel, enet_uint32 a_flags);
+    void Send(Outbox& a_outbox);
+    bool Emit(CHANNEL a_channel, ENetPacket* a_packet);
+
+    PlayerData* m_player = nullptr;
+    std::vector<PendingPacket>* m_pending = nullptr;
+    std::size_t m_maxSize = BundleMaxSize;
+    std::size_t m_compressionThreshold = 0;
+    std::vector<Outbox> m_outboxes; // Gardés entre deux destinataires : les buffers ne sont pas réalloués
+    byteArray_t m_message;
+};
+
+#endif //_SV_NETWORK_HPP
@@ -1,12 +1,21 @@
 #ifndef _SV_PLAYERS_HPP
 #define _SV_PLAYERS_HPP 1
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <string>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <type_traits>
 #include <enet6/enet.h>
 
 #include "sv_math.hpp"
+#include "sv_fixed.hpp"
+#include "sv_arena.hpp"
 #include "sv_constant.hpp"
+#include "sv_config.hpp"
 
 #pragma region deprecated
 
@@ -21,69 +30,296 @@ struct PlayerInputs
     uint32_t inputIndex = 0;
 };
 
+// Index de l'input appliqué à chaque tick physique, le client peut ainsi rejouer exactement depuis n'importe quel tick
+struct InputAckHistory
+{
+    std::array<std::uint32_t, InputAckHistorySize> inputIndices{};
+    std::uint32_t lastTick = 0;
+    std::uint32_t count = 0;
+
+    void Reset() { count = 0; }
+
+    void Record(std::uint32_t a_tick, std::uint32_t a_inputIndex)
+    {
+        inputIndices[a_tick % InputAckHistorySize] = a_inputIndex;
+        lastTick = a_tick;
+        count = std::min<std::uint32_t>(count + 1, InputAckHistorySize);
+    }
+
+    std::uint32_t FirstTick() const { return lastTick - count + 1; }
+    std::uint32_t Get(std::uint32_t a_tick) const { return inputIndices[a_tick % InputAckHistorySize]; }
+};
+
+// Nom stocké dans le joueur, sans allocation : PlayerData reste copiable par memcpy
+struct PlayerName
+{
+    std::array<char, MaxPlayerNameLength> data{};
+    std::uint8_t length = 0;
+
+    bool empty() const { return length == 0; }
+    void clear() { length = 0; }
+    std::string_view view() const { return std::string_view(data.data(), length); }
+
+    void assign(std::string_view a_name)
+    {
+        length = static_cast<std::uint8_t>(std::min(a_name.size(), MaxPlayerNameLength));
+        std::memcpy(data.data(), a_name.data(), length);
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& a_stream, const PlayerName& a_name)
+{
+    return a_stream << a_name.view();
+}
+
 struct PlayerData
 {
     ENetPeer* peer = nullptr;
     idSize_t id;
-    std::string name;
+    PlayerName name;
     
     PLAYER_STATE state = PLAYER_STATE::connecting;
     Vector3f position;
     Vector3f velocity;
     PlayerInputs inputs;
     PlayerInputs lastInput;
+    InputAckHistory inputAcks;
+
+    std::int32_t sendBudget = 0; // Octets encore envoyables ce tick réseau
+
+    bool isBot = false; // Simulé par le serveur, sans peer
+    std::uint8_t capabilities = 0; // CAPABILITY négociées avec le client
+
+    std::uint64_t sessionToken = 0;     // 0 -> pas de session
+    std::uint32_t disconnectTime = 0;   // get_server_time() de la coupure, la place reste réservée pendant la période de grâce
+
+    // Recopiés du peer à la connexion : la simulation ne déréférence jamais peer, possédé par le thread réseau
+    std::uint32_t connection = 0;
+    std::uint32_t mtu = 0;
+    std::uint8_t channelCount = 0;
+    std::uint32_t roundTripTime = 0; // ms, mis à jour à chaque commande reçue
+
+    std::uint32_t partyId = 0; // Groupe annoncé dans PlayerInfo, 0 -> seul
+
+    // Physique en virgule fixe (physics.fixed_point) : fait foi tant que position / velocity en sont la conversion
+    FixedVector3 fixedPosition;
+    FixedVector3 fixedVelocity;
+
+    std::uint64_t lastSnapshotHash = 0;  // Hash du dernier snapshot complet envoyé à ce joueur
+    std::uint8_t unchangedSnapshots = 0; // Snapshots réduits au hash depuis le dernier complet
 
     PlayerData(idSize_t ID) : id(ID) {}
 
-    bool IsWorm() { return state == PLAYER_STATE::worm; }
+    bool IsWorm() const { return state == PLAYER_STATE::worm; }
+    PLAYER_ROLE Role() const { return IsWorm() ? PLAYER_ROLE::worm : PLAYER_ROLE::human; }
 };
 
-inline bool IsOnGround(PlayerData a_playerData)
+static_assert(std::is_trivially_copyable_v<PlayerData>, "PlayerData must stay trivially copyable (no owning members)");
+
+// Vue sur les joueurs d'une salle, le tick travaille directement dessus
+using PlayerSpan = std::span<PlayerData>;
+
+// a_groundLevel : hauteur du terrain sous le joueur + niveau du rôle (les humains marchent dessus, les vers nagent dessous)
+inline bool IsOnGround(const PlayerData& a_playerData, float a_groundLevel, const PhysicsSettings& a_physics)
 {
-    return a_playerData.position.y <= GetGroundLevel(a_playerData.state == PLAYER_STATE::worm) + GroundingTolerance;
+    return a_playerData.position.y <= a_groundLevel + a_physics.groundingTolerance;
+}
+
+// Déplace la capsule de l'humain en glissant le long des obstacles, retourne le déplacement réellement effectué
+inline Vector3f SlideAgainstObstacles(PlayerData& a_playerData, Vector3f a_motion, const PhysicsSettings& a_physics, const ObstacleBVH& a_obstacles)
+{
+    if (a_obstacles.Empty())
+        return a_motion;
+
+    Capsule capsule{ a_playerData.position, a_physics.humanHalfHeight, a_physics.humanRadius };
+    Vector3f applied = Vector3f::Zero();
+
+    for (int iteration = 0; iteration < ObstacleSlideIterations; ++iteration)
+    {
+        SweepHit hit;
+        if (!a_obstacles.SweepCapsule(capsule, a_motion, hit))
+        {
+            applied += a_motion;
+            return applied;
+        }
+
+        // Avance jusqu'au contact en gardant une marge, puis retire la composante qui rentre dans l'obstacle
+        Vector3f step = a_motion * hit.fraction + hit.normal * ObstacleSkin;
+        applied += step;
+        capsule.center += step;
+
+        Vector3f remaining = a_motion * (1.0f - hit.fraction);
+        a_motion = remaining - hit.normal * Vector3f::Dot(remaining, hit.normal);
+
+        float into = Vector3f::Dot(a_playerData.velocity, hit.normal);
+        if (into < 0.0f)
+            a_playerData.velocity -= hit.normal * into;
+    }
+
+    // Coincé entre plusieurs obstacles : on s'arrête là
+    return applied;
 }
 
-inline void UpdatePhysics(PlayerData& a_playerData, float a_deltaTime)
+// Rôle connu à la compilation dans tout le noyau : pas de test IsWorm() ni de sélection de constantes par joueur.
+// Les valeurs du rôle sont lues une fois par partition (a_role), la config restant rechargeable à chaud
+template<PLAYER_ROLE Role>
+inline void UpdatePhysics(PlayerData& a_playerData, const PhysicsSettings& a_physics, const RolePhysics& a_role, const Arena& a_arena, float a_deltaTime)
 {
-    if (a_playerData.inputs.jump && IsOnGround(a_playerData))
+    // Un seul échantillon de terrain par joueur et par tick
+    TerrainSample ground = a_arena.terrain.Sample(a_playerData.position.x, a_playerData.position.z);
+    float groundLevel = ground.height + a_role.groundLevel;
+
+    // Une pente trop raide ne porte pas : impossible d'y sauter ou d'y prendre appui
+    bool walkable = ground.normal.y >= a_physics.minGroundNormalY;
+
+    if (a_playerData.inputs.jump && walkable && IsOnGround(a_playerData, groundLevel, a_physics))
     {
-        if (!a_playerData.IsWorm())
+        if constexpr (Role == PLAYER_ROLE::human)
         {
-            a_playerData.velocity.y = HJumpPower;
+            a_playerData.velocity.y = a_physics.humanJumpPower;
         }
     }
     else
     {
-        a_playerData.velocity.y -= HGravity * a_deltaTime;
+        a_playerData.velocity.y -= a_physics.gravity * a_deltaTime;
 
-        if (a_playerData.position.y + a_playerData.velocity.y <= HGroundLevel + GroundingTolerance)
+        if (a_playerData.position.y + a_playerData.velocity.y <= groundLevel + a_physics.groundingTolerance)
         {
-            a_playerData.position.y = HGroundLevel;
+            a_playerData.position.y = groundLevel;
             a_playerData.velocity.y = 0.0f;
         }
     }
 
-    if (IsOnGround(a_playerData))
+    if (walkable && IsOnGround(a_playerData, groundLevel, a_physics))
     {
-        a_playerData.velocity.x += a_playerData.inputs.direction.x * GetAcceleration(a_playerData.IsWorm()) * a_deltaTime;
-        a_playerData.velocity.z += a_playerData.inputs.direction.y * GetAcceleration(a_playerData.IsWorm()) * a_deltaTime;
-        
-        Vector2f m_decelerationVector = Vector2f(a_playerData.velocity.x, a_playerData.velocity.z).normalized() * -1;
-        a_playerData.velocity.x -= m_decelerationVector.x * GetDeceleration(a_playerData.IsWorm()) * a_deltaTime;
-        a_playerData.velocity.z -= m_decelerationVector.y * GetDeceleration(a_playerData.IsWorm()) * a_deltaTime;
-        
-        if (a_playerData.velocity.x > GetVMax(a_playerData.IsWorm()))
-            a_playerData.velocity.x = GetVMax(a_playerData.IsWorm());
-        else if (a_playerData.velocity.x < -GetVMax(a_playerData.IsWorm()))
-            a_playerData.velocity.x = -GetVMax(a_playerData.IsWorm());
-
-        if (a_playerData.velocity.z > GetVMax(a_playerData.IsWorm()))
-            a_playerData.velocity.z = GetVMax(a_playerData.IsWorm());
-        else if (a_playerData.velocity.z < -GetVMax(a_playerData.IsWorm()))
-            a_playerData.velocity.z = -GetVMax(a_playerData.IsWorm());
+        a_playerData.velocity.x += a_playerData.inputs.direction.x * a_role.acceleration * a_deltaTime;
+        a_playerData.velocity.z += a_playerData.inputs.direction.y * a_role.acceleration * a_deltaTime;
+
+        // Freinage opposé à la vitesse horizontale, sans la dépasser : un joueur immobile reste exactement à 0.
+        // Même règle que UpdatePhysicsFixed et PlayerBehavior.cs côté client
+        Vector2f horizontal(a_playerData.velocity.x, a_playerData.velocity.z);
+        float speed = horizontal.magnitude();
+        float deceleration = a_role.deceleration * a_deltaTime;
+        if (speed <= deceleration)
+        {
+            a_playerData.velocity.x = 0.0f;
+            a_playerData.velocity.z = 0.0f;
+        }
+        else
+        {
+            float ratio = (speed - deceleration) / speed;
+            a_playerData.velocity.x *= ratio;
+            a_playerData.velocity.z *= ratio;
+        }
+
+        a_playerData.velocity.x = std::clamp(a_playerData.velocity.x, -a_role.vMax, a_role.vMax);
+        a_playerData.velocity.z = std::clamp(a_playerData.velocity.z, -a_role.vMax, a_role.vMax);
     }
-    
-    a_playerData.position += a_playerData.velocity * a_deltaTime;
+
+    // Les vers se déplacent sous terre et ignorent les obstacles
+    Vector3f motion = a_playerData.velocity * a_deltaTime;
+    if constexpr (Role == PLAYER_ROLE::human)
+        motion = SlideAgainstObstacles(a_playerData, motion, a_physics, a_arena.obstacles);
+
+    a_playerData.position += motion;
+}
+
+// RolePhysics et réglages communs convertis une fois par partition
+struct FixedRolePhysics
+{
+    Fixed vMax;
+    Fixed acceleration;
+    Fixed deceleration;
+    Fixed groundLevel;
+    Fixed groundingTolerance;
+    Fixed gravity;
+    Fixed jumpPower;
+
+    static FixedRolePhysics From(const PhysicsSettings& a_physics, const RolePhysics& a_role)
+    {
+        return { Fixed::FromFloat(a_role.vMax), Fixed::FromFloat(a_role.acceleration), Fixed::FromFloat(a_role.deceleration), Fixed::FromFloat(a_role.groundLevel),
+            Fixed::FromFloat(a_physics.groundingTolerance), Fixed::FromFloat(a_physics.gravity), Fixed::FromFloat(a_physics.humanJumpPower) };
+    }
+};
+
+// Même déroulé que UpdatePhysics en Q16.16 avec un pas fixe : à entrées égales, état identique au bit près.
+// Terrain et obstacles sont interrogés en float et leurs résultats ramenés en Q16.16
+template<PLAYER_ROLE Role>
+inline void UpdatePhysicsFixed(PlayerData& a_playerData, const PhysicsSettings& a_physics, const FixedRolePhysics& a_role, const Arena& a_arena, Fixed a_deltaTime)
+{
+    // Position ou vitesse réécrites ailleurs (apparition, reprise, changement de mode) : on repart de la valeur flottante
+    FixedVector3& position = a_playerData.fixedPosition;
+    FixedVector3& velocity = a_playerData.fixedVelocity;
+    Vector3f currentPosition = position.ToVector();
+    Vector3f currentVelocity = velocity.ToVector();
+    if (currentPosition.x != a_playerData.position.x || currentPosition.y != a_playerData.position.y || currentPosition.z != a_playerData.position.z)
+        position = FixedVector3::FromVector(a_playerData.position);
+    if (currentVelocity.x != a_playerData.velocity.x || currentVelocity.y != a_playerData.velocity.y || currentVelocity.z != a_playerData.velocity.z)
+        velocity = FixedVector3::FromVector(a_playerData.velocity);
+
+    TerrainSample ground = a_arena.terrain.Sample(a_playerData.position.x, a_playerData.position.z);
+    Fixed groundLevel = Fixed::FromFloat(ground.height) + a_role.groundLevel;
+    bool walkable = ground.normal.y >= a_physics.minGroundNormalY;
+
+    if (a_playerData.inputs.jump && walkable && position.y <= groundLevel + a_role.groundingTolerance)
+    {
+        if constexpr (Role == PLAYER_ROLE::human)
+        {
+            velocity.y = a_role.jumpPower;
+        }
+    }
+    else
+    {
+        velocity.y -= a_role.gravity * a_deltaTime;
+
+        if (position.y + velocity.y <= groundLevel + a_role.groundingTolerance)
+        {
+            position.y = groundLevel;
+            velocity.y = Fixed::Zero();
+        }
+    }
+
+    if (walkable && position.y <= groundLevel + a_role.groundingTolerance)
+    {
+        Fixed acceleration = a_role.acceleration * a_deltaTime;
+        velocity.x += Fixed::FromFloat(a_playerData.inputs.direction.x) * acceleration;
+        velocity.z += Fixed::FromFloat(a_playerData.inputs.direction.y) * acceleration;
+
+        // Freinage opposé à la vitesse horizontale, sans la dépasser : un joueur immobile reste exactement à 0
+        Fixed speed = Fixed::Sqrt(velocity.x * velocity.x + velocity.z * velocity.z);
+        Fixed deceleration = a_role.deceleration * a_deltaTime;
+        if (speed <= deceleration)
+        {
+            velocity.x = Fixed::Zero();
+            velocity.z = Fixed::Zero();
+        }
+        else
+        {
+            Fixed ratio = (speed - deceleration) / speed;
+            velocity.x = velocity.x * ratio;
+            velocity.z = velocity.z * ratio;
+        }
+
+        velocity.x = Fixed::Clamp(velocity.x, -a_role.vMax, a_role.vMax);
+        velocity.z = Fixed::Clamp(velocity.z, -a_role.vMax, a_role.vMax);
+    }
+
+    FixedVector3 motion{ velocity.x * a_deltaTime, velocity.y * a_deltaTime, velocity.z * a_deltaTime };
+
+    // Les vers se déplacent sous terre et ignorent les obstacles
+    if constexpr (Role == PLAYER_ROLE::human)
+    {
+        a_playerData.velocity = velocity.ToVector();
+        motion = FixedVector3::FromVector(SlideAgainstObstacles(a_playerData, motion.ToVector(), a_physics, a_arena.obstacles));
+        velocity = FixedVector3::FromVector(a_playerData.velocity);
+    }
+
+    position.x += motion.x;
+    position.y += motion.y;
+    position.z += motion.z;
+
+    a_playerData.position = position.ToVector();
+    a_playerData.velocity = velocity.ToVector();
 }
 
 #endif //_SV_PLAYERS_HPP
\ No newline at end of file
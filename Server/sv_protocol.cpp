@@ -120,6 +120,13 @@ void Serialize_u32(std::vector<std::uint8_t> &byteArray, std::size_t offset, std
 	std::memcpy(&byteArray[offset], &value, sizeof(value));
 }
 
+void Serialize_u64(std::vector<std::uint8_t> &byteArray, std::uint64_t value)
+{
+    // Big endian comme le reste : poids fort puis poids faible
+    Serialize_u32(byteArray, static_cast<std::uint32_t>(value >> 32));
+    Serialize_u32(byteArray, static_cast<std::uint32_t>(value));
+}
+
 void Serialize_str(std::vector<std::uint8_t> &byteArray, const std::string &value)
 {
     std::size_t offset = byteArray.size();
@@ -191,6 +198,13 @@ std::uint32_t Deserialize_u32(const std::vector<std::uint8_t> &byteArray, std::s
 
 	return value;
 }
+std::uint64_t Deserialize_u64(const std::vector<std::uint8_t> &byteArray, std::size_t &offset)
+{
+    std::uint64_t high = Deserialize_u32(byteArray, offset);
+    std::uint64_t low = Deserialize_u32(byteArray, offset);
+
+    return (high << 32) | low;
+}
 
 std::string Deserialize_str(const std::vector<std::uint8_t> &byteArray, std::size_t &offset)
 {
@@ -207,15 +221,36 @@ std::string Deserialize_str(const std::vector<std::uint8_t> &byteArray, std::siz
 
 #pragma region OP_COPE messages
 
+void StateHeader::Serialize(byteArray_t &byteArray) const
+{
+    Serialize_u32(byteArray, serverTick);
+    Serialize_u32(byteArray, serverTime);
+}
+StateHeader StateHeader::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
+{
+    StateHeader header;
+
+    header.serverTick = Deserialize_u32(byteArray, offset);
+    header.serverTime = Deserialize_u32(byteArray, offset);
+
+    return header;
+}
+
 void PlayerInfoPacket::Serialize(byteArray_t &byteArray) const
 {
     Serialize_str(byteArray, name);
+    Serialize_u8(byteArray, capabilities);
+    Serialize_u64(byteArray, sessionToken);
+    Serialize_u32(byteArray, partyId);
 }
 PlayerInfoPacket PlayerInfoPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
 {
     PlayerInfoPacket packet;
 
     packet.name = Deserialize_str(byteArray, offset);
+    packet.capabilities = Deserialize_u8(byteArray, offset);
+    packet.sessionToken = Deserialize_u64(byteArray, offset);
+    packet.partyId = Deserialize_u32(byteArray, offset);
 
     return packet;
 }
@@ -268,11 +303,19 @@ void GameDataPacket::Serialize(byteArray_t &byteArray) const
 {
     //TODO Recheck if necessary the bytesize of idSize_t in sv_constant
     Serialize_u8(byteArray, playerId);
+    Serialize_u16(byteArray, logicTickRate);
+    Serialize_u16(byteArray, networkTickRate);
+    Serialize_u8(byteArray, capabilities);
+    Serialize_u64(byteArray, sessionToken);
 }
 GameDataPacket GameDataPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
 {
     GameDataPacket packet;
     packet.playerId = Deserialize_u8(byteArray, offset);
+    packet.logicTickRate = Deserialize_u16(byteArray, offset);
+    packet.networkTickRate = Deserialize_u16(byteArray, offset);
+    packet.capabilities = Deserialize_u8(byteArray, offset);
+    packet.sessionToken = Deserialize_u64(byteArray, offset);
 
     return packet;
 }
@@ -308,6 +351,7 @@ WormAttackPacket WormAttackPacket::Deserialize(const byteArray_t &byteArray, std
 
 void PlayerListPacket::Serialize(byteArray_t &byteArray) const
 {
+    Serialize_u32(byteArray, rosterVersion);
     Serialize_u16(byteArray, players.size());
     for (const auto& player : players)
     {
@@ -319,6 +363,7 @@ PlayerListPacket PlayerListPacket::Deserialize(const byteArray_t &byteArray, std
 {
     PlayerListPacket packet;
 
+    packet.rosterVersion = Deserialize_u32(byteArray, offset);
     packet.players.resize(Deserialize_u16(byteArray, offset));
     for (auto& player : packet.players)
     {
@@ -329,8 +374,68 @@ PlayerListPacket PlayerListPacket::Deserialize(const byteArray_t &byteArray, std
     return packet;
 }
 
+void RosterUpdatePacket::Serialize(byteArray_t &byteArray) const
+{
+    Serialize_u32(byteArray, baseVersion);
+    Serialize_u16(byteArray, changes.size());
+    for (const auto& change : changes)
+    {
+        Serialize_u8(byteArray, static_cast<std::uint8_t>(change.op));
+        Serialize_u8(byteArray, change.id);
+        if (change.op != ROSTER_OP::Leave)
+            Serialize_str(byteArray, change.name);
+    }
+}
+RosterUpdatePacket RosterUpdatePacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
+{
+    RosterUpdatePacket packet;
+
+    packet.baseVersion = Deserialize_u32(byteArray, offset);
+    packet.changes.resize(Deserialize_u16(byteArray, offset));
+    for (auto& change : packet.changes)
+    {
+        change.op = static_cast<ROSTER_OP>(Deserialize_u8(byteArray, offset));
+        change.id = Deserialize_u8(byteArray, offset);
+        if (change.op != ROSTER_OP::Leave)
+            change.name = Deserialize_str(byteArray, offset);
+    }
+
+    return packet;
+}
+
+void RosterResyncPacket::Serialize(byteArray_t &byteArray) const
+{
+    Serialize_u32(byteArray, rosterVersion);
+}
+RosterResyncPacket RosterResyncPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
+{
+    RosterResyncPacket packet;
+
+    packet.rosterVersion = Deserialize_u32(byteArray, offset);
+
+    return packet;
+}
+
+void SnapshotResyncPacket::Serialize(byteArray_t &byteArray) const
+{
+    Serialize_u32(byteArray, serverTick);
+    Serialize_u64(byteArray, stateHash);
+}
+SnapshotResyncPacket SnapshotResyncPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
+{
+    SnapshotResyncPacket packet;
+
+    packet.serverTick = Deserialize_u32(byteArray, offset);
+    packet.stateHash = Deserialize_u64(byteArray, offset);
+
+    return packet;
+}
+
 void PlayersPositionPacket::Serialize(byteArray_t &byteArray) const
 {
+    header.Serialize(byteArray);
+    Serialize_u64(byteArray, stateHash);
+
     Serialize_u16(byteArray, players.size());
     for (const auto& player : players)
     {
@@ -349,11 +454,21 @@ void PlayersPositionPacket::Serialize(byteArray_t &byteArray) const
     }
 
     Serialize_u32(byteArray, lastInputIndex);
+
+    Serialize_u32(byteArray, firstAckTick);
+    Serialize_u8(byteArray, static_cast<std::uint8_t>(ackedInputs.size()));
+    for (std::uint32_t inputIndex : ackedInputs)
+    {
+        Serialize_u32(byteArray, inputIndex);
+    }
 }
 PlayersPositionPacket PlayersPositionPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
 {
     PlayersPositionPacket packet;
 
+    packet.header = StateHeader::Deserialize(byteArray, offset);
+    packet.stateHash = Deserialize_u64(byteArray, offset);
+
     packet.players.resize(Deserialize_u16(byteArray, offset));
     for (auto& player : packet.players)
     {
@@ -373,6 +488,13 @@ PlayersPositionPacket PlayersPositionPacket::Deserialize(const byteArray_t &byte
 
     packet.lastInputIndex = Deserialize_u32(byteArray, offset);
 
+    packet.firstAckTick = Deserialize_u32(byteArray, offset);
+    packet.ackedInputs.resize(Deserialize_u8(byteArray, offset));
+    for (auto& inputIndex : packet.ackedInputs)
+    {
+        inputIndex = Deserialize_u32(byteArray, offset);
+    }
+
     return packet;
 }
 
@@ -391,19 +513,27 @@ CountDownPacket CountDownPacket::Deserialize(const byteArray_t &byteArray, std::
 
 void PlayersMakeSoundPacket::Serialize(byteArray_t &byteArray) const
 {
-    Serialize_u8(byteArray, id);
-    Serialize_f32(byteArray, position.x);
-    Serialize_f32(byteArray, position.y);
-    Serialize_f32(byteArray, position.z);
+    Serialize_u16(byteArray, sounds.size());
+    for (const auto& sound : sounds)
+    {
+        Serialize_u8(byteArray, sound.id);
+        Serialize_f32(byteArray, sound.position.x);
+        Serialize_f32(byteArray, sound.position.y);
+        Serialize_f32(byteArray, sound.position.z);
+    }
 }
 PlayersMakeSoundPacket PlayersMakeSoundPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
 {
     PlayersMakeSoundPacket packet;
 
-    packet.id = Deserialize_u8(byteArray, offset);
-    packet.position.x = Deserialize_f32(byteArray, offset);
-    packet.position.y = Deserialize_f32(byteArray, offset);
-    packet.position.z = Deserialize_f32(byteArray, offset);
+    packet.sounds.resize(Deserialize_u16(byteArray, offset));
+    for (auto& sound : packet.sounds)
+    {
+        sound.id = Deserialize_u8(byteArray, offset);
+        sound.position.x = Deserialize_f32(byteArray, offset);
+        sound.position.y = Deserialize_f32(byteArray, offset);
+        sound.position.z = Deserialize_f32(byteArray, offset);
+    }
 
     return packet;
 }
@@ -423,6 +553,8 @@ WormNearPacket WormNearPacket::Deserialize(const byteArray_t &byteArray, std::si
 
 void WaitingStatePacket::Serialize(byteArray_t &byteArray) const
 {
+    header.Serialize(byteArray);
+
     Serialize_u16(byteArray, players.size());
     for (const auto& player : players)
     {
@@ -437,6 +569,8 @@ WaitingStatePacket WaitingStatePacket::Deserialize(const byteArray_t &byteArray,
 {
     WaitingStatePacket packet;
 
+    packet.header = StateHeader::Deserialize(byteArray, offset);
+
     packet.players.resize(Deserialize_u16(byteArray, offset));
     for (auto& player : packet.players)
     {
@@ -452,6 +586,8 @@ WaitingStatePacket WaitingStatePacket::Deserialize(const byteArray_t &byteArray,
 
 void GameStartStatePacket::Serialize(byteArray_t &byteArray) const
 {
+    header.Serialize(byteArray);
+
     Serialize_u16(byteArray, players.size());
     for (const auto& player : players)
     {
@@ -470,6 +606,8 @@ GameStartStatePacket GameStartStatePacket::Deserialize(const byteArray_t &byteAr
 {
     GameStartStatePacket packet;
 
+    packet.header = StateHeader::Deserialize(byteArray, offset);
+
     packet.players.resize(Deserialize_u16(byteArray, offset));
     for (auto& player : packet.players)
     {
@@ -489,6 +627,8 @@ GameStartStatePacket GameStartStatePacket::Deserialize(const byteArray_t &byteAr
 
 void WormArriveStatePacket::Serialize(byteArray_t &byteArray) const
 {
+    header.Serialize(byteArray);
+
     Serialize_u8(byteArray, wormId);
     Serialize_i16(byteArray, coutdown);
 }
@@ -496,6 +636,8 @@ WormArriveStatePacket WormArriveStatePacket::Deserialize(const byteArray_t &byte
 {
     WormArriveStatePacket packet;
 
+    packet.header = StateHeader::Deserialize(byteArray, offset);
+
     packet.wormId = Deserialize_u8(byteArray, offset);
     packet.coutdown = Deserialize_i16(byteArray, offset);
 
@@ -504,6 +646,8 @@ WormArriveStatePacket WormArriveStatePacket::Deserialize(const byteArray_t &byte
 
 void FinishedStatePacket::Serialize(byteArray_t &byteArray) const
 {
+    header.Serialize(byteArray);
+
     Serialize_u16(byteArray, players.size());
     for (const auto& player : players)
     {
@@ -515,6 +659,8 @@ FinishedStatePacket FinishedStatePacket::Deserialize(const byteArray_t &byteArra
 {
     FinishedStatePacket packet;
 
+    packet.header = StateHeader::Deserialize(byteArray, offset);
+
     packet.players.resize(Deserialize_u16(byteArray, offset));
     for (auto& player : packet.players)
     {
@@ -525,5 +671,32 @@ FinishedStatePacket FinishedStatePacket::Deserialize(const byteArray_t &byteArra
     return packet;
 }
 
-#pragma endregion
+void TimeSyncRequestPacket::Serialize(byteArray_t &byteArray) const
+{
+    Serialize_u32(byteArray, clientTime);
+}
+TimeSyncRequestPacket TimeSyncRequestPacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
+{
+    TimeSyncRequestPacket packet;
+
+    packet.clientTime = Deserialize_u32(byteArray, offset);
+
+    return packet;
+}
+
+void TimeSyncResponsePacket::Serialize(byteArray_t &byteArray) const
+{
+    Serialize_u32(byteArray, clientTime);
+    header.Serialize(byteArray);
+}
+TimeSyncResponsePacket TimeSyncResponsePacket::Deserialize(const byteArray_t &byteArray, std::size_t &offset)
+{
+    TimeSyncResponsePacket packet;
+
+    packet.clientTime = Deserialize_u32(byteArray, offset);
+    packet.header = StateHeader::Deserialize(byteArray, offset);
+
+    return packet;
+}
 
+#pragma endregion
\ No newline at end of file
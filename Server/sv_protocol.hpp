@@ -24,6 +24,7 @@ void Serialize_i32(std::vector<std::uint8_t>& byteArray, std::int32_t value);
 void Serialize_i32(std::vector<std::uint8_t>& byteArray, std::size_t offset, std::int32_t value);
 void Serialize_u32(std::vector<std::uint8_t>& byteArray, std::uint32_t value);
 void Serialize_u32(std::vector<std::uint8_t>& byteArray, std::size_t offset, std::uint32_t value);
+void Serialize_u64(std::vector<std::uint8_t>& byteArray, std::uint64_t value);
 void Serialize_str(std::vector<std::uint8_t>& byteArray, const std::string& value);
 void Serialize_str(std::vector<std::uint8_t>& byteArray, std::size_t offset, const std::string& value);
 
@@ -34,6 +35,7 @@ std::int16_t Deserialize_i16(const std::vector<std::uint8_t>& byteArray, std::si
 std::uint16_t Deserialize_u16(const std::vector<std::uint8_t>& byteArray, std::size_t& offset);
 std::int32_t Deserialize_i32(const std::vector<std::uint8_t>& byteArray, std::size_t& offset);
 std::uint32_t Deserialize_u32(const std::vector<std::uint8_t>& byteArray, std::size_t& offset);
+std::uint64_t Deserialize_u64(const std::vector<std::uint8_t>& byteArray, std::size_t& offset);
 std::string Deserialize_str(const std::vector<std::uint8_t>& byteArray, std::size_t& offset);
 
 #pragma endregion
@@ -58,14 +60,51 @@ enum class OP_CODE : std::uint8_t
     S_WaitingState,
     S_GameStartState,
     S_WormArriveState,
-    S_FinishedState
+    S_FinishedState,
+
+    C_TimeSync,
+    S_TimeSync,
+
+    // Plusieurs messages dans un seul packet : [Bundle] puis pour chaque message [u16 taille][opcode + contenu]
+    Bundle,
+    // Message compressé : [Compressed][u16 taille décompressée][flux LZ] (voir sv_compress.hpp)
+    Compressed,
+
+    // Ajoutés à la fin : les opcodes existants gardent leur valeur
+    S_RosterUpdate,
+    C_RosterResync,
+    C_SnapshotResync
+};
+
+// Modification de la liste des joueurs, chacune fait avancer la version du roster de 1
+enum class ROSTER_OP : std::uint8_t
+{
+    Join,
+    Leave,
+    Rename
+};
+
+// En tête des packets d'état : place chaque état sur la timeline serveur pour l'interpolation client
+struct StateHeader
+{
+    std::uint32_t serverTick;
+    std::uint32_t serverTime; // ms depuis le démarrage du serveur
+
+    void Serialize(byteArray_t& byteArray) const;
+    static StateHeader Deserialize(const byteArray_t& byteArray, std::size_t& offset);
 };
 
 struct PlayerInfoPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::C_PlayerInfo;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     std::string name;
+    std::uint8_t capabilities = 0; // CAPABILITY supportées par le client
+    std::uint64_t sessionToken = 0; // Token reçu dans GameData pour reprendre sa place après une coupure, 0 -> nouvelle session
+    std::uint32_t partyId = 0; // Choisi par les clients d'un même groupe pour jouer ensemble, 0 -> seul
     // Personalistion
 
     void Serialize(byteArray_t& byteArray) const;
@@ -75,6 +114,9 @@ struct PlayerInfoPacket
 struct PlayerInputPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::C_PlayerInput;
+    static constexpr CHANNEL channel = CHANNEL::Input;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_UNSEQUENCED;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     PlayerInputs inputs;
 
@@ -85,6 +127,9 @@ struct PlayerInputPacket
 struct PlayerReadyPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::C_PlayerReady;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     bool isReady;
 
@@ -95,8 +140,15 @@ struct PlayerReadyPacket
 struct GameDataPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_GameData;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     idSize_t playerId;
+    std::uint16_t logicTickRate;
+    std::uint16_t networkTickRate;
+    std::uint8_t capabilities; // CAPABILITY retenues pour ce client
+    std::uint64_t sessionToken; // À renvoyer dans PlayerInfo en cas de reconnexion
 
     void Serialize(byteArray_t& byteArray) const;
     static GameDataPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
@@ -105,6 +157,9 @@ struct GameDataPacket
 struct WormAttackPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_WormAttack;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     std::vector<idSize_t> targetId; // Empty if None
     Vector3f attackPosition;
@@ -116,6 +171,9 @@ struct WormAttackPacket
 struct PlayerListPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_PlayerList;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     struct Player
     {
@@ -124,15 +182,70 @@ struct PlayerListPacket
         // Personnalisation
     };
 
+    std::uint32_t rosterVersion = 0; // Version de la liste, les RosterUpdate suivants partent d'elle
     std::vector<Player> players;
 
     void Serialize(byteArray_t& byteArray) const;
     static PlayerListPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
 };
 
+// Modifications de la liste depuis baseVersion, dans l'ordre : le client arrive à baseVersion + changes.size().
+// Un client qui n'a pas baseVersion (ni mieux) demande la liste complète avec RosterResync
+struct RosterUpdatePacket
+{
+    static constexpr OP_CODE opcode = OP_CODE::S_RosterUpdate;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
+
+    struct Change
+    {
+        ROSTER_OP op;
+        idSize_t id;
+        std::string name; // Absent du message pour Leave
+    };
+
+    std::uint32_t baseVersion = 0;
+    std::vector<Change> changes;
+
+    void Serialize(byteArray_t& byteArray) const;
+    static RosterUpdatePacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
+};
+
+struct RosterResyncPacket
+{
+    static constexpr OP_CODE opcode = OP_CODE::C_RosterResync;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
+
+    std::uint32_t rosterVersion; // Version du client, pour le diagnostic
+
+    void Serialize(byteArray_t& byteArray) const;
+    static RosterResyncPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
+};
+
+// Un snapshot réduit au hash ne correspond pas au dernier snapshot complet reçu : le serveur renvoie l'état complet, en fiable
+struct SnapshotResyncPacket
+{
+    static constexpr OP_CODE opcode = OP_CODE::C_SnapshotResync;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
+
+    std::uint32_t serverTick; // Snapshot qui a révélé l'écart, pour le diagnostic
+    std::uint64_t stateHash;  // Hash gardé par le client
+
+    void Serialize(byteArray_t& byteArray) const;
+    static SnapshotResyncPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
+};
+
 struct PlayersPositionPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_PlayerPosition;
+    static constexpr CHANNEL channel = CHANNEL::Snapshot;
+    static constexpr enet_uint32 flags = 0;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Low;
 
     struct PlayerData
     {
@@ -142,9 +255,15 @@ struct PlayersPositionPacket
         Vector2f inputs;
     };
 
+    StateHeader header;
+    std::uint64_t stateHash = 0; // FNV-1a des joueurs en Q16.16 (physics.fixed_point), 0 -> pas de hash. players vide : monde inchangé depuis le dernier snapshot complet
     std::vector<PlayerData> players;
     std::uint32_t lastInputIndex; // Last input of sended player
 
+    // ackedInputs[i] : index de l'input appliqué au tick firstAckTick + i pour le joueur destinataire
+    std::uint32_t firstAckTick;
+    std::vector<std::uint32_t> ackedInputs;
+
     void Serialize(byteArray_t& byteArray) const;
     static PlayersPositionPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
 };
@@ -152,6 +271,9 @@ struct PlayersPositionPacket
 struct CountDownPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_Countdown;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
     std::uint16_t countdown;
 
@@ -162,9 +284,18 @@ struct CountDownPacket
 struct PlayersMakeSoundPacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_PlayerMakeSound;
+    static constexpr CHANNEL channel = CHANNEL::Snapshot;
+    static constexpr enet_uint32 flags = 0;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Low;
+
+    struct Sound
+    {
+        idSize_t id;
+        Vector3f position;
+    };
 
-    idSize_t id;
-    Vector3f position;
+    // Tous les sons d'un tick réseau, au plus un par joueur
+    std::vector<Sound> sounds;
 
     void Serialize(byteArray_t& byteArray) const;
     static PlayersMakeSoundPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
@@ -172,7 +303,10 @@ struct PlayersMakeSoundPacket
 
 struct WormNearPacket
 {
-    static constexpr OP_CODE opcode = OP_CODE::S_PlayerMakeSound;
+    static constexpr OP_CODE opcode = OP_CODE::S_WormNear;
+    static constexpr CHANNEL channel = CHANNEL::Snapshot;
+    static constexpr enet_uint32 flags = 0;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Low;
 
     float nearRatio;
 
@@ -183,7 +317,11 @@ struct WormNearPacket
 struct WaitingStatePacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_WaitingState;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
+    StateHeader header;
     struct PlayerData
     {
         idSize_t id;
@@ -199,7 +337,11 @@ struct WaitingStatePacket
 struct GameStartStatePacket
 {
     static constexpr OP_CODE opcode = OP_CODE::S_GameStartState;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
+    StateHeader header;
     struct PlayerData
     {
         idSize_t id;
@@ -216,8 +358,12 @@ struct GameStartStatePacket
 
 struct WormArriveStatePacket
 {
-    static constexpr OP_CODE opcode = OP_CODE::S_GameStartState;
+    static constexpr OP_CODE opcode = OP_CODE::S_WormArriveState;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
+    StateHeader header;
     idSize_t wormId;
     std::int16_t coutdown;
 
@@ -227,8 +373,12 @@ struct WormArriveStatePacket
 
 struct FinishedStatePacket
 {
-    static constexpr OP_CODE opcode = OP_CODE::S_GameStartState;
+    static constexpr OP_CODE opcode = OP_CODE::S_FinishedState;
+    static constexpr CHANNEL channel = CHANNEL::Control;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
+    StateHeader header;
     struct Player
     {
         idSize_t id;
@@ -241,15 +391,50 @@ struct FinishedStatePacket
     static FinishedStatePacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
 };
 
-#pragma endregion
+// Le client envoie son heure, le serveur répond aussitôt avec la sienne : RTT et offset d'horloge côté client
+struct TimeSyncRequestPacket
+{
+    static constexpr OP_CODE opcode = OP_CODE::C_TimeSync;
+    static constexpr CHANNEL channel = CHANNEL::Input;
+    static constexpr enet_uint32 flags = ENET_PACKET_FLAG_UNSEQUENCED;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
 
-template<typename T> ENetPacket* build_packet(const T& packet, enet_uint32 flags)
+    std::uint32_t clientTime;
+
+    void Serialize(byteArray_t& byteArray) const;
+    static TimeSyncRequestPacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
+};
+
+struct TimeSyncResponsePacket
 {
-	// On sérialise l'opcode puis le contenu du packet dans un std::vector<std::uint8_t>
-	std::vector<std::uint8_t> byteArray;
+    static constexpr OP_CODE opcode = OP_CODE::S_TimeSync;
+    static constexpr CHANNEL channel = CHANNEL::Snapshot;
+    static constexpr enet_uint32 flags = 0;
+    static constexpr SEND_PRIORITY priority = SEND_PRIORITY::Critical;
+
+    std::uint32_t clientTime;
+    StateHeader header;
 
+    void Serialize(byteArray_t& byteArray) const;
+    static TimeSyncResponsePacket Deserialize(const byteArray_t& byteArray, std::size_t& offset);
+};
+
+#pragma endregion
+
+// Opcode puis contenu, ajoutés à la fin de byteArray
+template<typename T> void serialize_message(const T& packet, byteArray_t& byteArray)
+{
 	Serialize_u8(byteArray, static_cast<std::uint8_t>(T::opcode));
 	packet.Serialize(byteArray);
+}
+
+template<typename T> ENetPacket* build_packet(const T& packet, enet_uint32 flags)
+{
+	// On sérialise l'opcode puis le contenu du packet dans un buffer réutilisé, sans allocation une fois chaud
+	thread_local std::vector<std::uint8_t> byteArray;
+	byteArray.clear();
+
+	serialize_message(packet, byteArray);
 
 	// On copie le contenu de ce vector dans un packet enet, et on l'envoie au peer
 	return enet_packet_create(byteArray.data(), byteArray.size(), flags);
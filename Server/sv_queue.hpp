@@ -0,0 +1,102 @@
+#ifndef _SV_QUEUE_HPP
+#define _SV_QUEUE_HPP 1
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Ligne de cache : producteur et consommateur n'écrivent pas sur la même
+constexpr std::size_t CacheLineSize = 64;
+
+// File circulaire sans verrou, un seul thread producteur et un seul thread consommateur.
+// Les éléments restent construits dans le tableau et sont déplacés à l'entrée et à la sortie
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producteur uniquement. false si la file est pleine, a_value n'est alors pas déplacé
+    bool TryPush(T&& a_value)
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity)
+                return false;
+        }
+
+        m_items[tail & (Capacity - 1)] = std::move(a_value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur uniquement
+    bool TryPop(T& a_value)
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+                return false;
+        }
+
+        a_value = std::move(m_items[head & (Capacity - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximatif vu de l'autre thread
+    bool Empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+private:
+    // Index croissants sans modulo, seul l'accès au tableau est masqué
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head = 0;
+    std::size_t m_cachedTail = 0; // Copie de m_tail côté consommateur
+
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail = 0;
+    std::size_t m_cachedHead = 0; // Copie de m_head côté producteur
+
+    alignas(CacheLineSize) std::array<T, Capacity> m_items{};
+};
+
+// Triple tampon sans verrou, un seul écrivain et un seul lecteur. L'écrivain remplit Back() puis le publie,
+// le lecteur récupère la dernière version publiée : aucun des deux n'attend l'autre et les versions intermédiaires sont sautées
+template<typename T>
+class TripleBuffer
+{
+public:
+    // Écrivain uniquement : contenu d'une version antérieure, à réécrire entièrement
+    T& Back() { return m_buffers[m_back]; }
+
+    // Écrivain uniquement : Back() devient la version publiée et l'écrivain récupère le tampon intermédiaire
+    void Publish()
+    {
+        m_back = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // Lecteur uniquement : dernière version publiée, valide jusqu'au prochain appel
+    const T& Read()
+    {
+        if (m_middle.load(std::memory_order_relaxed) & FreshBit)
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & IndexMask;
+
+        return m_buffers[m_front];
+    }
+
+private:
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t FreshBit = 0x4; // Le tampon intermédiaire n'a pas encore été lu
+
+    std::array<T, 3> m_buffers{};
+
+    alignas(CacheLineSize) std::atomic<std::uint8_t> m_middle = 1;
+    alignas(CacheLineSize) std::uint8_t m_back = 0;
+    alignas(CacheLineSize) std::uint8_t m_front = 2;
+};
+
+#endif //_SV_QUEUE_HPP
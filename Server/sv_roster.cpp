@@ -0,0 +1,33 @@
+#include "sv_roster.hpp"
+
+void Roster::Record(ROSTER_OP a_op, idSize_t a_id, std::string_view a_name)
+{
+    auto& change = m_update.changes.emplace_back();
+    change.op = a_op;
+    change.id = a_id;
+    change.name = a_name;
+
+    ++m_version;
+}
+
+void Roster::Clear()
+{
+    m_update.changes.clear();
+    m_update.baseVersion = m_version;
+}
+
+void Roster::FillPlayerList(PlayerListPacket& a_packet, std::span<const PlayerData> a_players) const
+{
+    a_packet.rosterVersion = m_version;
+
+    a_packet.players.clear();
+    for (const PlayerData& player : a_players)
+    {
+        if (player.name.empty())
+            continue;
+
+        auto& packetPlayer = a_packet.players.emplace_back();
+        packetPlayer.id = player.id;
+        packetPlayer.name = player.name.view();
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef _SV_ROSTER_HPP
+#define _SV_ROSTER_HPP 1
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "sv_constant.hpp"
+#include "sv_players.hpp"
+#include "sv_protocol.hpp"
+
+// Liste des joueurs d'une salle telle que les clients la connaissent (joueurs nommés, bots compris).
+// Chaque modification est enregistrée et fait avancer la version, les modifications d'un tick réseau
+// partent ensemble dans un RosterUpdate. La liste complète n'est envoyée qu'à l'arrivée ou sur demande
+class Roster
+{
+public:
+    void Join(idSize_t a_id, std::string_view a_name) { Record(ROSTER_OP::Join, a_id, a_name); }
+    void Leave(idSize_t a_id) { Record(ROSTER_OP::Leave, a_id, {}); }
+    void Rename(idSize_t a_id, std::string_view a_name) { Record(ROSTER_OP::Rename, a_id, a_name); }
+
+    std::uint32_t Version() const { return m_version; }
+
+    // Modifications depuis le dernier Clear, à diffuser à tous les clients nommés
+    bool HasChanges() const { return !m_update.changes.empty(); }
+    const RosterUpdatePacket& Update() const { return m_update; }
+    void Clear();
+
+    // Liste complète à la version courante, construite depuis les joueurs de la salle
+    void FillPlayerList(PlayerListPacket& a_packet, std::span<const PlayerData> a_players) const;
+
+private:
+    // Jamais fusionnées : un client qui a reçu la liste complète en cours de tick rattrape le reste par index
+    void Record(ROSTER_OP a_op, idSize_t a_id, std::string_view a_name);
+
+    std::uint32_t m_version = 0;
+    RosterUpdatePacket m_update; // baseVersion = version au dernier Clear
+};
+
+#endif //_SV_ROSTER_HPP
@@ -0,0 +1,75 @@
+#include "sv_terrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+bool Heightfield::Init(const float* a_heights, std::uint32_t a_width, std::uint32_t a_depth, float a_cellSize, float a_originX, float a_originZ)
+{
+    if (a_heights == nullptr || a_width < 2 || a_depth < 2 || a_cellSize <= 0.0f
+        || a_width % TerrainTileSize != 0 || a_depth % TerrainTileSize != 0)
+    {
+        return false;
+    }
+
+    m_heights = a_heights;
+    m_width = a_width;
+    m_depth = a_depth;
+    m_tilesX = a_width / TerrainTileSize;
+    m_cellSize = a_cellSize;
+    m_invCellSize = 1.0f / a_cellSize;
+    m_originX = a_originX;
+    m_originZ = a_originZ;
+
+    return true;
+}
+
+Heightfield::Cell Heightfield::LocateCell(float a_x, float a_z) const
+{
+    // Hors de la grille on prolonge le bord
+    float gx = std::clamp((a_x - m_originX) * m_invCellSize, 0.0f, static_cast<float>(m_width - 1));
+    float gz = std::clamp((a_z - m_originZ) * m_invCellSize, 0.0f, static_cast<float>(m_depth - 1));
+
+    std::uint32_t ix = std::min(static_cast<std::uint32_t>(gx), m_width - 2);
+    std::uint32_t iz = std::min(static_cast<std::uint32_t>(gz), m_depth - 2);
+
+    Cell cell;
+    cell.h00 = GetSample(ix, iz);
+    cell.h10 = GetSample(ix + 1, iz);
+    cell.h01 = GetSample(ix, iz + 1);
+    cell.h11 = GetSample(ix + 1, iz + 1);
+    cell.fx = gx - static_cast<float>(ix);
+    cell.fz = gz - static_cast<float>(iz);
+
+    return cell;
+}
+
+float Heightfield::SampleHeight(float a_x, float a_z) const
+{
+    if (IsFlat())
+        return 0.0f;
+
+    Cell cell = LocateCell(a_x, a_z);
+
+    float h0 = cell.h00 + (cell.h10 - cell.h00) * cell.fx;
+    float h1 = cell.h01 + (cell.h11 - cell.h01) * cell.fx;
+    return h0 + (h1 - h0) * cell.fz;
+}
+
+TerrainSample Heightfield::Sample(float a_x, float a_z) const
+{
+    if (IsFlat())
+        return { 0.0f, Vector3f::Up() };
+
+    Cell cell = LocateCell(a_x, a_z);
+
+    float h0 = cell.h00 + (cell.h10 - cell.h00) * cell.fx;
+    float h1 = cell.h01 + (cell.h11 - cell.h01) * cell.fx;
+
+    // Dérivées du patch bilinéaire, la normale est (-dh/dx, 1, -dh/dz) normalisée
+    float dhdx = ((cell.h10 - cell.h00) + ((cell.h11 - cell.h01) - (cell.h10 - cell.h00)) * cell.fz) * m_invCellSize;
+    float dhdz = (h1 - h0) * m_invCellSize;
+
+    float invLength = 1.0f / std::sqrt(dhdx * dhdx + 1.0f + dhdz * dhdz);
+
+    return { h0 + (h1 - h0) * cell.fz, Vector3f(-dhdx * invLength, invLength, -dhdz * invLength) };
+}
@@ -0,0 +1,65 @@
+#ifndef _SV_TERRAIN_HPP
+#define _SV_TERRAIN_HPP 1
+
+#include <cstdint>
+
+#include "sv_math.hpp"
+
+// Côté d'une tuile en échantillons : 8x8 floats = 256 octets, un échantillon bilinéaire touche au plus 4 tuiles
+constexpr std::uint32_t TerrainTileSize = 8;
+
+struct TerrainSample
+{
+    float height;
+    Vector3f normal;
+};
+
+// Vue sur une grille de hauteurs rangée par tuiles (les données appartiennent au fichier de map mappé)
+// Sans données, le terrain est plat à la hauteur 0
+class Heightfield
+{
+public:
+    Heightfield() = default;
+
+    // a_heights : width * depth floats, tuiles de TerrainTileSize² rangées ligne par ligne
+    bool Init(const float* a_heights, std::uint32_t a_width, std::uint32_t a_depth, float a_cellSize, float a_originX, float a_originZ);
+
+    bool IsFlat() const { return m_heights == nullptr; }
+
+    float SampleHeight(float a_x, float a_z) const;
+    TerrainSample Sample(float a_x, float a_z) const;
+
+    std::uint32_t Width() const { return m_width; }
+    std::uint32_t Depth() const { return m_depth; }
+    float CellSize() const { return m_cellSize; }
+    float OriginX() const { return m_originX; }
+    float OriginZ() const { return m_originZ; }
+
+    // Hauteur de l'échantillon (a_ix, a_iz), indices déjà bornés
+    float GetSample(std::uint32_t a_ix, std::uint32_t a_iz) const
+    {
+        std::uint32_t tile = (a_iz / TerrainTileSize) * m_tilesX + (a_ix / TerrainTileSize);
+        std::uint32_t inTile = (a_iz % TerrainTileSize) * TerrainTileSize + (a_ix % TerrainTileSize);
+        return m_heights[tile * TerrainTileSize * TerrainTileSize + inTile];
+    }
+
+private:
+    struct Cell
+    {
+        float h00, h10, h01, h11; // Coins (x, z)
+        float fx, fz;             // Position dans la cellule [0, 1]
+    };
+
+    Cell LocateCell(float a_x, float a_z) const;
+
+    const float* m_heights = nullptr;
+    std::uint32_t m_width = 0;
+    std::uint32_t m_depth = 0;
+    std::uint32_t m_tilesX = 0;
+    float m_cellSize = 1.0f;
+    float m_invCellSize = 1.0f;
+    float m_originX = 0.0f;
+    float m_originZ = 0.0f;
+};
+
+#endif //_SV_TERRAIN_HPP
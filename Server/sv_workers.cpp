@@ -0,0 +1,93 @@
+#include "sv_workers.hpp"
+
+void WorkerPool::Start(std::size_t a_threadCount)
+{
+    Stop();
+
+    // Un pool redémarré garde son compteur : les threads ne partent que de la prochaine tâche
+    m_stopping = false;
+    for (std::size_t i = 0; i < a_threadCount; ++i)
+        m_threads.emplace_back(&WorkerPool::WorkerLoop, this, i + 1, m_generation);
+}
+
+void WorkerPool::Stop()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+
+    m_threads.clear();
+}
+
+void WorkerPool::Run(std::size_t a_count, void* a_context, JobFunction a_function)
+{
+    if (a_count == 0)
+        return;
+
+    // Pas la peine de réveiller qui que ce soit pour une seule tâche
+    if (m_threads.empty() || a_count == 1)
+    {
+        for (std::size_t i = 0; i < a_count; ++i)
+            a_function(a_context, 0, i);
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_context = a_context;
+        m_function = a_function;
+        m_count = a_count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_activeThreads = m_threads.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    Process(0);
+
+    // La tâche vit sur la pile de l'appelant : on attend que plus aucun thread ne puisse la toucher
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this] { return m_activeThreads == 0; });
+}
+
+void WorkerPool::WorkerLoop(std::size_t a_worker, std::uint64_t a_generation)
+{
+    std::uint64_t seenGeneration = a_generation;
+
+    while (true)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+
+            if (m_stopping)
+                return;
+
+            seenGeneration = m_generation;
+        }
+
+        Process(a_worker);
+
+        bool last;
+        {
+            std::lock_guard lock(m_mutex);
+            last = --m_activeThreads == 0;
+        }
+
+        if (last)
+            m_done.notify_one();
+    }
+}
+
+void WorkerPool::Process(std::size_t a_worker)
+{
+    // Un index à la fois : les tâches sont longues (un client entier), l'équilibrage compte plus que le coût de l'atomique
+    std::size_t index;
+    while ((index = m_next.fetch_add(1, std::memory_order_relaxed)) < m_count)
+        m_function(m_context, a_worker, index);
+}
@@ -0,0 +1,63 @@
+#ifndef _SV_WORKERS_HPP
+#define _SV_WORKERS_HPP 1
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Threads qui se partagent les index d'une boucle. Le thread appelant travaille aussi (worker 0) :
+// sans thread démarré, ParallelFor se réduit à une boucle ordinaire
+class WorkerPool
+{
+public:
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool() { Stop(); }
+
+    // a_threadCount threads en plus de l'appelant
+    void Start(std::size_t a_threadCount);
+    void Stop();
+
+    // Threads qui exécutent les tâches, appelant compris : les index de worker vont de 0 à WorkerCount() - 1
+    std::size_t WorkerCount() const { return m_threads.size() + 1; }
+
+    // Appelle a_job(worker, index) pour chaque index de [0, a_count) et retourne quand tous sont traités.
+    // Un même worker ne traite jamais deux index à la fois : ses buffers peuvent lui être propres
+    template<typename Job> void ParallelFor(std::size_t a_count, Job&& a_job)
+    {
+        Run(a_count, &a_job, [](void* a_context, std::size_t a_worker, std::size_t a_index)
+        {
+            (*static_cast<std::remove_reference_t<Job>*>(a_context))(a_worker, a_index);
+        });
+    }
+
+private:
+    using JobFunction = void(*)(void*, std::size_t, std::size_t);
+
+    void Run(std::size_t a_count, void* a_context, JobFunction a_function);
+    void WorkerLoop(std::size_t a_worker, std::uint64_t a_generation);
+    void Process(std::size_t a_worker);
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::uint64_t m_generation = 0; // Incrémenté à chaque ParallelFor, sous m_mutex, par le seul thread propriétaire
+    bool m_stopping = false;
+
+    // Tâche en cours, publiée sous m_mutex avant le réveil
+    void* m_context = nullptr;
+    JobFunction m_function = nullptr;
+    std::size_t m_count = 0;
+    std::atomic<std::size_t> m_next = 0;    // Prochain index à prendre
+    std::size_t m_activeThreads = 0;        // Threads pas encore revenus de la tâche, sous m_mutex
+};
+
+#endif //_SV_WORKERS_HPP
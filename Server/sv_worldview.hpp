@@ -0,0 +1,38 @@
+#ifndef _SV_WORLDVIEW_HPP
+#define _SV_WORLDVIEW_HPP 1
+
+#include <cstdint>
+#include <vector>
+
+#include "sv_constant.hpp"
+#include "sv_math.hpp"
+#include "sv_players.hpp"
+#include "sv_queue.hpp"
+
+// Copie figée d'un joueur, sans peer ni état interne de la simulation
+struct WorldViewPlayer
+{
+    idSize_t id;
+    PlayerName name;
+    PLAYER_STATE state;
+    Vector3f position;
+    Vector3f velocity;
+    Vector2f direction;
+    bool isBot;
+    bool connected;
+};
+
+// État d'une salle à la fin d'un tick. Publiée par le thread de simulation, lue sans verrou par les autres threads
+// (stats, observateurs, requêtes d'admin) qui ne doivent jamais toucher GameData
+struct WorldView
+{
+    std::uint32_t tick = 0;
+    std::uint32_t serverTime = 0;
+    GAME_STATE state = GAME_STATE::waiting;
+    std::vector<WorldViewPlayer> players; // Joueurs présents (nom non vide), garde sa capacité d'une publication à l'autre
+};
+
+// Un seul lecteur par salle : le thread principal
+using WorldViewBuffer = TripleBuffer<WorldView>;
+
+#endif //_SV_WORLDVIEW_HPP
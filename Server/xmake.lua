@@ -22,5 +22,5 @@ target("WormEaterServer")
     if is_plat("windows") then
         add_syslinks("ws2_32")
     else
-
+        add_syslinks("pthread")
     end
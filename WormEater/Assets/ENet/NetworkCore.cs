@@ -23,9 +23,31 @@ namespace Network
         private ENet6.Host m_enetHost = null;
         private ENet6.Peer? m_serverPeer = null;
         private GameData m_gameData;
+        private UInt64 m_sessionToken = 0; // Donné par le serveur, permet de reprendre sa place après une coupure
+        private UInt64 m_stateHash = 0; // Hash du dernier snapshot complet reçu
+        private bool m_snapshotResyncSent = false; // Une seule demande par snapshot complet reçu
+        private Dictionary<Byte, string> m_roster = new Dictionary<Byte, string>(); // Joueurs nommés de la salle
+        private UInt32 m_rosterVersion = 0;
+
+        // Gardés pour se reconnecter seul quand le serveur redémarre
+        private string m_address = null;
+        private ushort m_port = 0;
+        private string m_playerName = null;
+        private UInt32 m_partyId = 0;
 
         private Coroutine m_connectCoroutine = null;
 
+        // Reprise de session après une coupure : essais espacés de plus en plus, tant que le serveur garde la place
+        // (session_grace_period, 10 s par défaut côté serveur)
+        private const float SESSION_GRACE_PERIOD = 10f; // s
+        private const float RECONNECT_FIRST_DELAY = 0.25f; // s
+        private const float RECONNECT_MAX_DELAY = 2f; // s
+        private Coroutine m_reconnectCoroutine = null;
+
+        // Retry : le serveur choisit le shard par adresse, un nouvel essai ne sert que s'il n'a pas pu ; on ne boucle pas sans fin
+        private const int MAX_SHARD_RETRIES = 16;
+        private int m_shardRetries = 0;
+
         private NETWORK_STATE m_connectionState = NETWORK_STATE.Disconnected;
 
         public NETWORK_STATE MConnectionState
@@ -69,6 +91,9 @@ namespace Network
 
         public void Connect(string addressString, ushort port = 14769)
         {
+            m_address = addressString;
+            m_port = port;
+
             if (m_connectCoroutine == null)
                 StartCoroutine(ConnectRoutine(addressString, port));
         }
@@ -96,7 +121,7 @@ namespace Network
 
             m_enetHost = new ENet6.Host();
             m_enetHost.Create(address.Type, 1, 0);
-            m_serverPeer = m_enetHost.Connect(address, 0);
+            m_serverPeer = m_enetHost.Connect(address, (int)CHANNEL.Count);
 
             // On laisse la connexion se faire pendant un maximum de 50 * 100ms = 5s
             for (uint i = 0; i < 50; ++i)
@@ -124,9 +149,61 @@ namespace Network
             m_gameData = new GameData();
 
             MConnectionState = NETWORK_STATE.Connected;
+
+            // Reconnexion : le token rend au joueur sa place dans la partie
+            if (m_sessionToken != 0 && m_playerName != null)
+                SendPlayerInfo(m_playerName, m_partyId);
+
             yield break;
         }
 
+        // Connexion perdue sans que le serveur l'ait demandé : on reprend sa place avec le token tant qu'il la garde
+        private bool TryResumeSession()
+        {
+            if (m_sessionToken == 0 || m_address == null || m_playerName == null)
+                return false;
+
+            if (m_reconnectCoroutine == null)
+                m_reconnectCoroutine = StartCoroutine(ReconnectRoutine());
+
+            return true;
+        }
+
+        private IEnumerator ReconnectRoutine()
+        {
+            float deadline = Time.realtimeSinceStartup + SESSION_GRACE_PERIOD;
+            float delay = RECONNECT_FIRST_DELAY;
+
+            while (Time.realtimeSinceStartup + delay < deadline)
+            {
+                yield return new WaitForSecondsRealtime(delay);
+
+                Debug.Log($"Connection lost, resuming the session (retry in {delay}s)...");
+                yield return StartCoroutine(ConnectRoutine(m_address, m_port));
+
+                if (MConnectionState == NETWORK_STATE.Connected)
+                {
+                    m_reconnectCoroutine = null;
+                    yield break;
+                }
+
+                delay = Mathf.Min(delay * 2f, RECONNECT_MAX_DELAY);
+            }
+
+            Debug.LogWarning("Could not resume the session before the server released it");
+            m_sessionToken = 0;
+            m_reconnectCoroutine = null;
+        }
+
+        private void StopReconnect()
+        {
+            if (m_reconnectCoroutine == null)
+                return;
+
+            StopCoroutine(m_reconnectCoroutine);
+            m_reconnectCoroutine = null;
+        }
+
         public void Disconnect()
         {
             Debug.Log("disconnecting...");
@@ -147,6 +224,7 @@ namespace Network
 
         private void OnApplicationQuit()
         {
+            StopReconnect();
             Disconnect();
             ENet6.Library.Deinitialize();
         }
@@ -180,6 +258,21 @@ namespace Network
                             Debug.Log("Disconnect");
 
                             Disconnect();
+
+                            DISCONNECT_REASON reason = (DISCONNECT_REASON)evt.Data;
+                            if (reason == DISCONNECT_REASON.Retry && ++m_shardRetries > MAX_SHARD_RETRIES)
+                            {
+                                Debug.LogError($"Still not on the right shard after {MAX_SHARD_RETRIES} retries, giving up");
+                            }
+                            else if ((reason == DISCONNECT_REASON.Restart || reason == DISCONNECT_REASON.Retry) && m_address != null)
+                            {
+                                Debug.Log($"Server asked to reconnect ({reason}), reconnecting...");
+                                Connect(m_address, m_port);
+                            }
+                            else if (reason == DISCONNECT_REASON.None && TryResumeSession())
+                            {
+                                Debug.Log("Disconnected without reason, trying to resume the session");
+                            }
                             break;
 
                         case ENet6.EventType.Receive:
@@ -193,6 +286,9 @@ namespace Network
                             Debug.Log("Timeout");
 
                             Disconnect();
+
+                            // Lien instable : le serveur garde notre place pendant la période de grâce
+                            TryResumeSession();
                             break;
                     }
                 } while (m_enetHost.CheckEvents(out evt) > 0);
@@ -203,9 +299,35 @@ namespace Network
         {
             byte[] data = new byte[receivedPacket.Length];
             receivedPacket.CopyTo(data);
+            receivedPacket.Dispose();
+
+            if (data.Length == 0)
+                return;
 
-            int offset = 0;
+            if ((OP_CODE)data[0] != OP_CODE.Bundle)
+            {
+                HandleSingleMessage(ref data, 0, gameData);
+                return;
+            }
 
+            // Bundle : chaque message est précédé de sa taille
+            int offset = 1;
+            while (offset + 2 <= data.Length)
+            {
+                int length = ByteBuffer.Deserialize_u16(ref data, ref offset);
+                if (length == 0 || offset + length > data.Length)
+                {
+                    Debug.LogWarning("Handle Message : Malformed bundle");
+                    return;
+                }
+
+                HandleSingleMessage(ref data, offset, gameData);
+                offset += length;
+            }
+        }
+
+        void HandleSingleMessage(ref byte[] data, int offset, GameData gameData)
+        {
             OP_CODE opcode = (OP_CODE)ByteBuffer.Deserialize_u8(ref data, ref offset);
             switch (opcode)
             {
@@ -213,15 +335,100 @@ namespace Network
                 {
                     GameDataPacket packet = GameDataPacket.Deserialize(ref data, ref offset);
                     gameData.ownPlayerId = packet.id;
+                    m_sessionToken = packet.sessionToken;
+                    m_shardRetries = 0;
+                    m_stateHash = 0;
+                    m_snapshotResyncSent = false;
+                    m_roster.Clear();
+                    m_rosterVersion = 0;
                     Debug.Log($"Own player id : {(int)gameData.ownPlayerId}");
                     break;
                 }
                 case OP_CODE.S_PlayerList:
                 {
+                    PlayerListPacket packet = PlayerListPacket.Deserialize(ref data, ref offset);
+                    
+                    m_roster.Clear();
+                    foreach (PlayerListPacket.Player player in packet.players)
+                        m_roster[player.id] = player.name;
+                    
+                    m_rosterVersion = packet.rosterVersion;
+                    break;
+                }
+                case OP_CODE.S_RosterUpdate:
+                {
+                    RosterUpdatePacket packet = RosterUpdatePacket.Deserialize(ref data, ref offset);
+                    
+                    // Déjà connu (liste complète reçue pendant le même tick)
+                    if (packet.baseVersion + (UInt32)packet.changes.Count <= m_rosterVersion)
+                        break;
+                    
+                    if (packet.baseVersion > m_rosterVersion)
+                    {
+                        Debug.LogWarning($"Roster {packet.baseVersion} : missed updates since {m_rosterVersion}, asking for the full list");
+                        SendRosterResync();
+                        break;
+                    }
+                    
+                    for (int i = (int)(m_rosterVersion - packet.baseVersion); i < packet.changes.Count; i++)
+                    {
+                        RosterUpdatePacket.Change change = packet.changes[i];
+                        if (change.op == ROSTER_OP.Leave)
+                            m_roster.Remove(change.id);
+                        else
+                            m_roster[change.id] = change.name;
+                    }
+                    
+                    m_rosterVersion = packet.baseVersion + (UInt32)packet.changes.Count;
                     break;
                 }
                 case OP_CODE.S_PlayerPosition:
                 {
+                    PlayerPositionPacket packet = PlayerPositionPacket.Deserialize(ref data, ref offset);
+                    if (packet.stateHash == 0)
+                        break;
+                    
+                    if (packet.players.Count == 0)
+                    {
+                        // Snapshot réduit au hash : l'état déjà reçu reste bon s'il correspond, sinon (complet perdu) on demande l'état complet
+                        if (packet.stateHash != m_stateHash && !m_snapshotResyncSent)
+                        {
+                            Debug.LogWarning($"Snapshot {packet.header.serverTick} : state diverged, asking for a full snapshot");
+                            m_snapshotResyncSent = SendSnapshotResync(packet.header.serverTick);
+                        }
+                        break;
+                    }
+                    
+                    m_stateHash = packet.stateHash;
+                    m_snapshotResyncSent = false;
+                    break;
+                }
+
+                case OP_CODE.S_GameStartState:
+                {
+                    GameStartStatePacket packet = GameStartStatePacket.Deserialize(ref data, ref offset);
+                    gameData.state = GAME_STATE.game;
+                    Debug.Log($"Match started with {packet.players.Count} players");
+                    break;
+                }
+                case OP_CODE.S_FinishedState:
+                {
+                    FinishedStatePacket packet = FinishedStatePacket.Deserialize(ref data, ref offset);
+                    gameData.state = GAME_STATE.waiting;
+                    Debug.Log($"Match finished ({packet.players.Count} players), back in the matchmaking queue");
+                    break;
+                }
+
+                case OP_CODE.Compressed:
+                {
+                    byte[] decompressed = Compression.Decompress(data, offset);
+                    if (decompressed == null || decompressed.Length == 0 || (OP_CODE)decompressed[0] == OP_CODE.Compressed || (OP_CODE)decompressed[0] == OP_CODE.Bundle)
+                    {
+                        Debug.LogWarning("Handle Message : Invalid compressed message");
+                        break;
+                    }
+                    
+                    HandleSingleMessage(ref decompressed, 0, gameData);
                     break;
                 }
 
@@ -230,11 +437,10 @@ namespace Network
                     Debug.LogWarning($"Handle Message : Unexpected opcode ({(int)opcode})");
                     break;
             }
-
-            receivedPacket.Dispose();
         }
 
-        public bool SendPlayerInfo(string name)
+        // partyId : même valeur pour les amis qui veulent jouer la même partie, 0 = seul
+        public bool SendPlayerInfo(string name, UInt32 partyId = 0)
         {
             if (m_serverPeer == null)
             {
@@ -242,11 +448,48 @@ namespace Network
                 return false;
             }
 
+            m_playerName = name;
+            m_partyId = partyId;
+
             PlayerInfoPacket infoPacket = new PlayerInfoPacket();
             infoPacket.name = name;
+            infoPacket.capabilities = CAPABILITY.Compression;
+            infoPacket.sessionToken = m_sessionToken;
+            infoPacket.partyId = partyId;
 
             Packet packet = ByteBuffer.build_packet(infoPacket, PacketFlags.Reliable);
-            return m_serverPeer.Value.Send(0, ref packet);
+            return m_serverPeer.Value.Send((byte)CHANNEL.Control, ref packet);
+        }
+
+        public bool SendRosterResync()
+        {
+            if (m_serverPeer == null)
+            {
+                Debug.LogError($"SendRosterResync : Cannot send packet, server peer is null");
+                return false;
+            }
+
+            RosterResyncPacket resyncPacket = new RosterResyncPacket();
+            resyncPacket.rosterVersion = m_rosterVersion;
+
+            Packet packet = ByteBuffer.build_packet(resyncPacket, PacketFlags.Reliable);
+            return m_serverPeer.Value.Send((byte)CHANNEL.Control, ref packet);
+        }
+
+        public bool SendSnapshotResync(UInt32 serverTick)
+        {
+            if (m_serverPeer == null)
+            {
+                Debug.LogError($"SendSnapshotResync : Cannot send packet, server peer is null");
+                return false;
+            }
+
+            SnapshotResyncPacket resyncPacket = new SnapshotResyncPacket();
+            resyncPacket.serverTick = serverTick;
+            resyncPacket.stateHash = m_stateHash;
+
+            Packet packet = ByteBuffer.build_packet(resyncPacket, PacketFlags.Reliable);
+            return m_serverPeer.Value.Send((byte)CHANNEL.Control, ref packet);
         }
 
         public bool SendPlayerReady(bool ready)
@@ -261,7 +504,7 @@ namespace Network
             readyPacket.isReady = ready;
 
             Packet packet = ByteBuffer.build_packet(readyPacket, PacketFlags.Reliable);
-            return m_serverPeer.Value.Send(0, ref packet);
+            return m_serverPeer.Value.Send((byte)CHANNEL.Control, ref packet);
         }
     }
 }
@@ -70,9 +70,20 @@ public class PlayerBehavior : MonoBehaviour
             m_playerData.velocity.x += a_playerInputs.direction.x * PlayerConst.GetAcceleration(_isWorm) * a_deltaTime;
             m_playerData.velocity.z += a_playerInputs.direction.y * PlayerConst.GetAcceleration(_isWorm) * a_deltaTime;
             
-            Vector2 m_decelerationVector = new Vector2(m_playerData.velocity.x, m_playerData.velocity.z).normalized * -1;
-            m_playerData.velocity.x -= m_decelerationVector.x * PlayerConst.GetDeceleration(_isWorm) * a_deltaTime;
-            m_playerData.velocity.z -= m_decelerationVector.y * PlayerConst.GetDeceleration(_isWorm) * a_deltaTime;
+            // Freinage opposé à la vitesse horizontale, sans la dépasser : même règle que le serveur
+            float m_speed = new Vector2(m_playerData.velocity.x, m_playerData.velocity.z).magnitude;
+            float m_deceleration = PlayerConst.GetDeceleration(_isWorm) * a_deltaTime;
+            if (m_speed <= m_deceleration)
+            {
+                m_playerData.velocity.x = 0f;
+                m_playerData.velocity.z = 0f;
+            }
+            else
+            {
+                float m_ratio = (m_speed - m_deceleration) / m_speed;
+                m_playerData.velocity.x *= m_ratio;
+                m_playerData.velocity.z *= m_ratio;
+            }
             
             m_playerData.velocity.x = Mathf.Clamp(m_playerData.velocity.x, -PlayerConst.GetVMax(_isWorm), PlayerConst.GetVMax(_isWorm));
             m_playerData.velocity.z = Mathf.Clamp(m_playerData.velocity.z, -PlayerConst.GetVMax(_isWorm), PlayerConst.GetVMax(_isWorm));
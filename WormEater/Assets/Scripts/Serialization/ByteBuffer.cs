@@ -108,6 +108,12 @@ namespace Serialization
             // -> valueBytes.CopyTo(resByteArray, byteArray.Length);
             // Apparement plus rapide dans certains cas + standard bas niveau
         }
+        public static void Serialize_u64(ref byte[] byteArray, UInt64 value)
+        {
+            // Deux u32 big endian, poids fort en premier (comme le serveur)
+            Serialize_u32(ref byteArray, (UInt32)(value >> 32));
+            Serialize_u32(ref byteArray, (UInt32)(value & 0xFFFFFFFF));
+        }
         
         public static void Serialize_str(ref byte[] byteArray, string value )
         {
@@ -181,6 +187,12 @@ namespace Serialization
             offset += SIZE_32;
             return BitConverter.ToUInt32(valueBytes, 0);
         }
+        public static UInt64 Deserialize_u64(ref byte[] byteArray, ref int offset)
+        {
+            UInt64 high = Deserialize_u32(ref byteArray, ref offset);
+            UInt64 low = Deserialize_u32(ref byteArray, ref offset);
+            return (high << 32) | low;
+        }
         
         public static string Deserialize_str(ref byte[] byteArray, ref int offset)
         {
@@ -213,6 +225,96 @@ namespace Serialization
         }
     }
     
+    // Décodeur LZ du serveur (sv_compress.cpp), le dictionnaire doit rester identique octet pour octet
+    public static class Compression
+    {
+        private const int MIN_MATCH = 4;
+        
+        private static readonly byte[] s_dictionary = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x06, (byte)'P', (byte)'l', (byte)'a', (byte)'y', (byte)'e', (byte)'r',
+            0x00, 0x00, 0x00, 0x05, (byte)'B', (byte)'o', (byte)'t', (byte)' ', (byte)'1',
+            0x00, 0x00, 0x00, 0x05, (byte)'B', (byte)'o', (byte)'t', (byte)' ', (byte)'2',
+            0x3F, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xBF, 0x80, 0x00, 0x00,
+            0x3F, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0xC1, 0x1C, 0xF5, 0xC3,
+            0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x05, 0x00, 0x06, 0x00, 0x07, 0x00, 0x08
+        };
+        
+        private static bool ReadLength(byte[] input, ref int offset, ref int length)
+        {
+            if (length != 15)
+                return true;
+            
+            byte value;
+            do
+            {
+                if (offset >= input.Length)
+                    return false;
+                
+                value = input[offset++];
+                length += value;
+            } while (value == 255);
+            
+            return true;
+        }
+        
+        // offset : juste après l'opcode Compressed. Retourne null si le flux est invalide
+        public static byte[] Decompress(byte[] input, int offset)
+        {
+            if (offset + 2 > input.Length)
+                return null;
+            
+            int rawSize = (input[offset] << 8) | input[offset + 1];
+            offset += 2;
+            
+            int dictionarySize = s_dictionary.Length;
+            byte[] window = new byte[dictionarySize + rawSize];
+            Buffer.BlockCopy(s_dictionary, 0, window, 0, dictionarySize);
+            int position = dictionarySize;
+            
+            while (position < window.Length)
+            {
+                if (offset >= input.Length)
+                    return null;
+                
+                byte token = input[offset++];
+                
+                int literalCount = token >> 4;
+                if (!ReadLength(input, ref offset, ref literalCount) || offset + literalCount > input.Length || position + literalCount > window.Length)
+                    return null;
+                
+                Buffer.BlockCopy(input, offset, window, position, literalCount);
+                offset += literalCount;
+                position += literalCount;
+                
+                if (position == window.Length)
+                    break;
+                
+                if (offset + 2 > input.Length)
+                    return null;
+                
+                int distance = (input[offset] << 8) | input[offset + 1];
+                offset += 2;
+                
+                int length = token & 0x0F;
+                if (!ReadLength(input, ref offset, ref length))
+                    return null;
+                length += MIN_MATCH;
+                
+                if (distance == 0 || distance > position || position + length > window.Length)
+                    return null;
+                
+                // Octet par octet : la copie peut chevaucher ce qu'elle écrit
+                for (int i = 0; i < length; i++, position++)
+                    window[position] = window[position - distance];
+            }
+            
+            byte[] output = new byte[rawSize];
+            Buffer.BlockCopy(window, dictionarySize, output, 0, rawSize);
+            return output;
+        }
+    }
+    
     #region OP_CODE messages
     
     public enum OP_CODE : UInt8
@@ -233,7 +335,49 @@ namespace Serialization
         S_WaitingState,
         S_GameStartState,
         S_WormArriveState,
-        S_FinishedState
+        S_FinishedState,
+        
+        C_TimeSync,
+        S_TimeSync,
+        
+        // Plusieurs messages dans un seul packet : [Bundle] puis pour chaque message [u16 taille][opcode + contenu]
+        Bundle,
+        // Message compressé : [Compressed][u16 taille décompressée][flux LZ] (voir Compression)
+        Compressed,
+        
+        // Ajoutés à la fin : les opcodes existants gardent leur valeur
+        S_RosterUpdate,
+        C_RosterResync,
+        C_SnapshotResync
+    }
+    
+    public enum ROSTER_OP : UInt8
+    {
+        Join,
+        Leave,
+        Rename
+    }
+    
+    // En tête des packets d'état : tick et heure serveur pour placer l'état sur la timeline d'interpolation
+    public struct StateHeader
+    {
+        public UInt32 serverTick;
+        public UInt32 serverTime; // ms depuis le démarrage du serveur
+        
+        public void Serialize(ref byte[] byteArray)
+        {
+            ByteBuffer.Serialize_u32(ref byteArray, serverTick);
+            ByteBuffer.Serialize_u32(ref byteArray, serverTime);
+        }
+        public static StateHeader Deserialize(ref byte[] byteArray, ref int offset)
+        {
+            StateHeader header = new StateHeader();
+            
+            header.serverTick = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            header.serverTime = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            
+            return header;
+        }
     }
     
     public abstract class ModelPacket
@@ -248,16 +392,25 @@ namespace Serialization
         public override OP_CODE opcode => OP_CODE.C_PlayerInfo;
 
         public string name;
+        public CAPABILITY capabilities;
+        public UInt64 sessionToken; // 0 = nouvelle session
+        public UInt32 partyId; // Même valeur pour les membres d'un groupe, 0 = seul
         
         public override void Serialize(ref byte[] byteArray)
         {
             ByteBuffer.Serialize_str(ref byteArray, name);
+            ByteBuffer.Serialize_u8(ref byteArray, (UInt8)capabilities);
+            ByteBuffer.Serialize_u64(ref byteArray, sessionToken);
+            ByteBuffer.Serialize_u32(ref byteArray, partyId);
         }
         public static PlayerInfoPacket Deserialize(ref byte[] byteArray, ref int offset)
         {
             PlayerInfoPacket packet = new PlayerInfoPacket();
             
             packet.name = ByteBuffer.Deserialize_str(ref byteArray, ref offset);
+            packet.capabilities = (CAPABILITY)ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+            packet.sessionToken = ByteBuffer.Deserialize_u64(ref byteArray, ref offset);
+            packet.partyId = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
 
             return packet;
         }
@@ -327,16 +480,28 @@ namespace Serialization
         public override OP_CODE opcode => OP_CODE.S_GameData;
 
         public idSize_t id;
+        public UInt16 logicTickRate;
+        public UInt16 networkTickRate;
+        public CAPABILITY capabilities;
+        public UInt64 sessionToken; // À renvoyer dans PlayerInfoPacket pour reprendre la partie après une coupure
         
         public override void Serialize(ref byte[] byteArray)
         {
             ByteBuffer.Serialize_u8(ref byteArray, id);
+            ByteBuffer.Serialize_u16(ref byteArray, logicTickRate);
+            ByteBuffer.Serialize_u16(ref byteArray, networkTickRate);
+            ByteBuffer.Serialize_u8(ref byteArray, (UInt8)capabilities);
+            ByteBuffer.Serialize_u64(ref byteArray, sessionToken);
         }
         public static GameDataPacket Deserialize(ref byte[] byteArray, ref int offset)
         {
             GameDataPacket packet = new GameDataPacket();
             
             packet.id = ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+            packet.logicTickRate = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
+            packet.networkTickRate = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
+            packet.capabilities = (CAPABILITY)ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+            packet.sessionToken = ByteBuffer.Deserialize_u64(ref byteArray, ref offset);
 
             return packet;
         }
@@ -390,10 +555,12 @@ namespace Serialization
             // Personnalisation
         }
         
-        public List<Player> players;
+        public UInt32 rosterVersion; // Version de la liste, les RosterUpdate suivants partent de là
+        public List<Player> players = new List<Player>();
         
         public override void Serialize(ref byte[] byteArray)
         {
+            ByteBuffer.Serialize_u32(ref byteArray, rosterVersion);
             ByteBuffer.Serialize_u16(ref byteArray, (UInt16)players.Count);
             foreach (Player player in players)
             {
@@ -405,6 +572,7 @@ namespace Serialization
         {
             PlayerListPacket packet = new PlayerListPacket();
             
+            packet.rosterVersion = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
             UInt16 playerCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
             for (int i = 0; i < playerCount; i++)
             {
@@ -432,11 +600,21 @@ namespace Serialization
             public Vector2 input;
         }
         
-        public List<PlayerPos> players;
+        public StateHeader header;
+        // Hash des joueurs (physique en virgule fixe), 0 -> pas de hash. players vide : rien n'a changé depuis le dernier snapshot complet
+        public UInt64 stateHash;
+        public List<PlayerPos> players = new List<PlayerPos>();
         public UInt32 lastInputIndex;
         
+        // ackedInputs[i] : index de l'input appliqué par le serveur au tick firstAckTick + i
+        public UInt32 firstAckTick;
+        public List<UInt32> ackedInputs = new List<UInt32>();
+        
         public override void Serialize(ref byte[] byteArray)
         {
+            header.Serialize(ref byteArray);
+            ByteBuffer.Serialize_u64(ref byteArray, stateHash);
+            
             ByteBuffer.Serialize_u16(ref byteArray, (UInt16)players.Count);
             foreach (PlayerPos player in players)
             {
@@ -455,11 +633,19 @@ namespace Serialization
             }
             
             ByteBuffer.Serialize_u32(ref byteArray, lastInputIndex);
+            
+            ByteBuffer.Serialize_u32(ref byteArray, firstAckTick);
+            ByteBuffer.Serialize_u8(ref byteArray, (UInt8)ackedInputs.Count);
+            foreach (UInt32 inputIndex in ackedInputs)
+                ByteBuffer.Serialize_u32(ref byteArray, inputIndex);
         }
         public static PlayerPositionPacket Deserialize(ref byte[] byteArray, ref int offset)
         {
             PlayerPositionPacket packet = new PlayerPositionPacket();
             
+            packet.header = StateHeader.Deserialize(ref byteArray, ref offset);
+            packet.stateHash = ByteBuffer.Deserialize_u64(ref byteArray, ref offset);
+            
             UInt16 playerCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
             for (int i = 0; i < playerCount; i++)
             {
@@ -476,12 +662,17 @@ namespace Serialization
                 player.velocity.z = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
                 
                 player.input.x = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
-                player.input.x = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
+                player.input.y = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
                 
                 packet.players.Add(player);
             }
             
             packet.lastInputIndex = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            
+            packet.firstAckTick = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            UInt8 ackCount = ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+            for (int i = 0; i < ackCount; i++)
+                packet.ackedInputs.Add(ByteBuffer.Deserialize_u32(ref byteArray, ref offset));
 
             return packet;
         }
@@ -511,24 +702,42 @@ namespace Serialization
     {
         public override OP_CODE opcode => OP_CODE.S_PlayerMakeSound;
 
-        public idSize_t id;
-        public Vector3 position;
+        public struct Sound
+        {
+            public idSize_t id;
+            public Vector3 position;
+        }
+        
+        // Tous les sons d'un tick réseau, au plus un par joueur
+        public List<Sound> sounds = new List<Sound>();
         
         public override void Serialize(ref byte[] byteArray)
         {
-            ByteBuffer.Serialize_u8(ref byteArray, id);
-            ByteBuffer.Serialize_f32(ref byteArray, position.x);
-            ByteBuffer.Serialize_f32(ref byteArray, position.y);
-            ByteBuffer.Serialize_f32(ref byteArray, position.z);
+            ByteBuffer.Serialize_u16(ref byteArray, (UInt16)sounds.Count);
+            foreach (Sound sound in sounds)
+            {
+                ByteBuffer.Serialize_u8(ref byteArray, sound.id);
+                ByteBuffer.Serialize_f32(ref byteArray, sound.position.x);
+                ByteBuffer.Serialize_f32(ref byteArray, sound.position.y);
+                ByteBuffer.Serialize_f32(ref byteArray, sound.position.z);
+            }
         }
         public static PlayerMakeSound Deserialize(ref byte[] byteArray, ref int offset)
         {
             PlayerMakeSound packet = new PlayerMakeSound();
             
-            packet.id = ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
-            packet.position.x = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
-            packet.position.y = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
-            packet.position.z = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
+            UInt16 soundCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
+            for (int i = 0; i < soundCount; i++)
+            {
+                Sound sound = new Sound();
+                
+                sound.id = ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+                sound.position.x = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
+                sound.position.y = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
+                sound.position.z = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
+                
+                packet.sounds.Add(sound);
+            }
 
             return packet;
         }
@@ -558,6 +767,7 @@ namespace Serialization
     {
         public override OP_CODE opcode => OP_CODE.S_WaitingState;
 
+        public StateHeader header;
         public struct Player
         {
             public idSize_t id;
@@ -568,6 +778,8 @@ namespace Serialization
         
         public override void Serialize(ref byte[] byteArray)
         {
+            header.Serialize(ref byteArray);
+            
             ByteBuffer.Serialize_u16(ref byteArray, (UInt16)players.Count);
             foreach (Player player in players)
             {
@@ -582,6 +794,8 @@ namespace Serialization
         {
             WaitingStatePacket packet = new WaitingStatePacket();
             
+            packet.header = StateHeader.Deserialize(ref byteArray, ref offset);
+            
             UInt16 playerCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
             for (int i = 0; i < playerCount; i++)
             {
@@ -604,6 +818,7 @@ namespace Serialization
     {
         public override OP_CODE opcode => OP_CODE.S_GameStartState;
 
+        public StateHeader header;
         public struct Player
         {
             public idSize_t id;
@@ -611,11 +826,13 @@ namespace Serialization
             public PLAYER_STATE state;
         }
         
-        public List<Player> players;
+        public List<Player> players = new List<Player>();
         public Int16 countDown;
         
         public override void Serialize(ref byte[] byteArray)
         {
+            header.Serialize(ref byteArray);
+            
             ByteBuffer.Serialize_u16(ref byteArray, (UInt16)players.Count);
             foreach (Player player in players)
             {
@@ -634,6 +851,8 @@ namespace Serialization
         {
             GameStartStatePacket packet = new GameStartStatePacket();
             
+            packet.header = StateHeader.Deserialize(ref byteArray, ref offset);
+            
             UInt16 playerCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
             for (int i = 0; i < playerCount; i++)
             {
@@ -645,6 +864,8 @@ namespace Serialization
                 player.position.y = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
                 player.position.z = ByteBuffer.Deserialize_f32(ref byteArray, ref offset);
                 
+                player.state = (PLAYER_STATE)ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+                
                 packet.players.Add(player);
             }
             
@@ -658,11 +879,14 @@ namespace Serialization
     {
         public override OP_CODE opcode => OP_CODE.S_WormArriveState;
 
+        public StateHeader header;
         public idSize_t wormId;
         public Int16 countdown;
         
         public override void Serialize(ref byte[] byteArray)
         {
+            header.Serialize(ref byteArray);
+            
             ByteBuffer.Serialize_u8(ref byteArray, wormId);
             ByteBuffer.Serialize_i16(ref byteArray, countdown);
         }
@@ -670,6 +894,8 @@ namespace Serialization
         {
             WormArriveStatePacket packet = new WormArriveStatePacket();
             
+            packet.header = StateHeader.Deserialize(ref byteArray, ref offset);
+            
             packet.wormId = ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
             packet.countdown = ByteBuffer.Deserialize_i16(ref byteArray, ref offset);
 
@@ -681,16 +907,19 @@ namespace Serialization
     {
         public override OP_CODE opcode => OP_CODE.S_FinishedState;
 
+        public StateHeader header;
         public struct Player
         {
             public idSize_t id;
             public string name;
         }
         
-        public List<Player> players;
+        public List<Player> players = new List<Player>();
         
         public override void Serialize(ref byte[] byteArray)
         {
+            header.Serialize(ref byteArray);
+            
             ByteBuffer.Serialize_u16(ref byteArray, (UInt16)players.Count);
             foreach (Player player in players)
             {
@@ -702,6 +931,8 @@ namespace Serialization
         {
             FinishedStatePacket packet = new FinishedStatePacket();
             
+            packet.header = StateHeader.Deserialize(ref byteArray, ref offset);
+            
             UInt16 playerCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
             for (int i = 0; i < playerCount; i++)
             {
@@ -717,6 +948,143 @@ namespace Serialization
         }
     }
     
+    public class TimeSyncRequestPacket : ModelPacket
+    {
+        public override OP_CODE opcode => OP_CODE.C_TimeSync;
+
+        public UInt32 clientTime;
+        
+        public override void Serialize(ref byte[] byteArray)
+        {
+            ByteBuffer.Serialize_u32(ref byteArray, clientTime);
+        }
+        public static TimeSyncRequestPacket Deserialize(ref byte[] byteArray, ref int offset)
+        {
+            TimeSyncRequestPacket packet = new TimeSyncRequestPacket();
+            
+            packet.clientTime = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+
+            return packet;
+        }
+    }
+    
+    public class TimeSyncResponsePacket : ModelPacket
+    {
+        public override OP_CODE opcode => OP_CODE.S_TimeSync;
+
+        public UInt32 clientTime;
+        public StateHeader header;
+        
+        public override void Serialize(ref byte[] byteArray)
+        {
+            ByteBuffer.Serialize_u32(ref byteArray, clientTime);
+            header.Serialize(ref byteArray);
+        }
+        public static TimeSyncResponsePacket Deserialize(ref byte[] byteArray, ref int offset)
+        {
+            TimeSyncResponsePacket packet = new TimeSyncResponsePacket();
+            
+            packet.clientTime = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            packet.header = StateHeader.Deserialize(ref byteArray, ref offset);
+
+            return packet;
+        }
+    }
+    
+    // Modifications de la liste des joueurs depuis baseVersion, la i-ème amène la liste à baseVersion + i + 1
+    public class RosterUpdatePacket : ModelPacket
+    {
+        public override OP_CODE opcode => OP_CODE.S_RosterUpdate;
+
+        public struct Change
+        {
+            public ROSTER_OP op;
+            public idSize_t id;
+            public string name; // Absent pour Leave
+        }
+        
+        public UInt32 baseVersion;
+        public List<Change> changes = new List<Change>();
+        
+        public override void Serialize(ref byte[] byteArray)
+        {
+            ByteBuffer.Serialize_u32(ref byteArray, baseVersion);
+            ByteBuffer.Serialize_u16(ref byteArray, (UInt16)changes.Count);
+            foreach (Change change in changes)
+            {
+                ByteBuffer.Serialize_u8(ref byteArray, (UInt8)change.op);
+                ByteBuffer.Serialize_u8(ref byteArray, change.id);
+                if (change.op != ROSTER_OP.Leave)
+                    ByteBuffer.Serialize_str(ref byteArray, change.name);
+            }
+        }
+        public static RosterUpdatePacket Deserialize(ref byte[] byteArray, ref int offset)
+        {
+            RosterUpdatePacket packet = new RosterUpdatePacket();
+            
+            packet.baseVersion = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            UInt16 changeCount = ByteBuffer.Deserialize_u16(ref byteArray, ref offset);
+            for (int i = 0; i < changeCount; i++)
+            {
+                Change change = new Change();
+                
+                change.op = (ROSTER_OP)ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+                change.id = ByteBuffer.Deserialize_u8(ref byteArray, ref offset);
+                if (change.op != ROSTER_OP.Leave)
+                    change.name = ByteBuffer.Deserialize_str(ref byteArray, ref offset);
+                
+                packet.changes.Add(change);
+            }
+
+            return packet;
+        }
+    }
+    
+    // Demande de la liste complète quand un RosterUpdate ne suit pas la version connue
+    public class RosterResyncPacket : ModelPacket
+    {
+        public override OP_CODE opcode => OP_CODE.C_RosterResync;
+
+        public UInt32 rosterVersion;
+        
+        public override void Serialize(ref byte[] byteArray)
+        {
+            ByteBuffer.Serialize_u32(ref byteArray, rosterVersion);
+        }
+        public static RosterResyncPacket Deserialize(ref byte[] byteArray, ref int offset)
+        {
+            RosterResyncPacket packet = new RosterResyncPacket();
+            
+            packet.rosterVersion = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+
+            return packet;
+        }
+    }
+    
+    // Un snapshot réduit au hash ne correspond pas au dernier complet reçu : le serveur renvoie l'état complet
+    public class SnapshotResyncPacket : ModelPacket
+    {
+        public override OP_CODE opcode => OP_CODE.C_SnapshotResync;
+
+        public UInt32 serverTick;
+        public UInt64 stateHash;
+        
+        public override void Serialize(ref byte[] byteArray)
+        {
+            ByteBuffer.Serialize_u32(ref byteArray, serverTick);
+            ByteBuffer.Serialize_u64(ref byteArray, stateHash);
+        }
+        public static SnapshotResyncPacket Deserialize(ref byte[] byteArray, ref int offset)
+        {
+            SnapshotResyncPacket packet = new SnapshotResyncPacket();
+            
+            packet.serverTick = ByteBuffer.Deserialize_u32(ref byteArray, ref offset);
+            packet.stateHash = ByteBuffer.Deserialize_u64(ref byteArray, ref offset);
+
+            return packet;
+        }
+    }
+    
     #endregion
 }
 
@@ -17,6 +17,34 @@ namespace Constant
         dead
     }
 
+    // Doit rester aligné avec CHANNEL côté serveur (sv_constant.hpp)
+    public enum CHANNEL : UInt8
+    {
+        Control,  // Fiable
+        Snapshot, // Non fiable séquencé
+        Input,    // Non séquencé
+
+        Count
+    }
+
+    // Doit rester aligné avec CAPABILITY côté serveur (sv_constant.hpp)
+    [Flags]
+    public enum CAPABILITY : UInt8
+    {
+        None = 0,
+        Compression = 1 << 0
+    }
+
+    // Donnée de déconnexion ENet, doit rester aligné avec DISCONNECT_REASON côté serveur (sv_constant.hpp)
+    public enum DISCONNECT_REASON : UInt32
+    {
+        None,
+        Restart, // Redémarrage à chaud du serveur : on se reconnecte avec le token de session
+        Retry,   // Arrivé sur un autre shard que sa salle : on se reconnecte (nouveau port local)
+        Kicked,  // Coupé par un administrateur : pas de reconnexion
+        Draining // Serveur en cours d'arrêt : pas de reconnexion
+    }
+
     public enum GAME_STATE : UInt8
     {
         connecting,